@@ -0,0 +1,199 @@
+/// Example 4.1 : Custom executors with CPU pinning
+/// By Oleksiy Grechnyev, IT-JIM
+/// In 3.2, all nodes share the default executor (a thread pool) with SlowCalculator
+/// Cheap control nodes like FlowLimiterCalculator then wait for a free thread,
+/// and the latency jitters
+/// Here we define named executors in the graph, each with its own threads
+/// pinned to its own CPU cores, and assign every node to one of them
+/// Executors are created by our own class PinnedExecutor, which also collects statistics:
+/// utilization (busy fraction of the threads) and queue wait (how long tasks wait for a thread)
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <map>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/4_1/pinned_executor.h"
+
+//==============================================================================
+/// Print statistics of all our executors
+void printExecutorStats(const std::map<std::string, std::shared_ptr<mediapipe::PinnedExecutor>> &executors) {
+    using namespace std;
+    for (const auto &p : executors) {
+        mediapipe::PinnedExecutorStats s = p.second->GetStats();
+        cout << "EXECUTOR " << p.first << " : threads = " << s.numThreads << ", tasks = " << s.numTasks
+             << ", queue = " << s.queueSize << ", utilization = " << s.utilization
+             << ", wait avg = " << s.queueWaitAvgMs << " ms, wait max = " << s.queueWaitMaxMs << " ms" << endl;
+    }
+}
+
+//==============================================================================
+mediapipe::Status run() {
+    using namespace std;
+    using namespace mediapipe;
+
+    // The graph from 3.2 plus a PassThroughCalculator, with 2 executors:
+    // "control" (1 thread) for the cheap nodes, "heavy" (1 thread) for SlowCalculator
+    // (MP never runs Process() of the same node in parallel, so more threads would not help here)
+    // An executor is defined with the "executor" field, and a node is assigned to it with
+    // the node field "executor" (nodes without it go to the default executor)
+    // Our executors have the type "PinnedExecutor" and PinnedExecutorOptions (see pinned_executor.proto)
+    // Field cpu is the list of CPU cores for the executor threads, fix it for your computer!
+    // Try to put both executors on the same core, or remove the executors, and compare the stats
+    string protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        executor {
+            name: "control"
+            type: "PinnedExecutor"
+            options {
+                [mediapipe.PinnedExecutorOptions.ext] {
+                    num_threads: 1
+                    cpu: 0
+                }
+            }
+        }
+        executor {
+            name: "heavy"
+            type: "PinnedExecutor"
+            options {
+                [mediapipe.PinnedExecutorOptions.ext] {
+                    num_threads: 1
+                    cpu: 1
+                    cpu: 2
+                }
+            }
+        }
+        node {
+            calculator: "FlowLimiterCalculator"
+            executor: "control"
+            input_stream: "in"
+            input_stream: "FINISHED:out"
+            input_stream_info: {
+                tag_index: "FINISHED"
+                back_edge: true
+            }
+            output_stream: "out1"
+        }
+        node {
+            calculator: "SlowCalculator"
+            executor: "heavy"
+            input_stream: "IMAGE:out1"
+            output_stream: "IMAGE:out2"
+        }
+        node {
+            calculator: "PassThroughCalculator"
+            executor: "control"
+            input_stream: "out2"
+            output_stream: "out"
+        }
+        )";
+
+    // Parse config
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    // Create our executors from config, this must happen BEFORE graph.Initialize()
+    CalculatorGraph graph;
+    map<string, shared_ptr<PinnedExecutor>> executors;
+    MP_RETURN_IF_ERROR(SetUpPinnedExecutors(&config, &graph, &executors));
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    // Mutex protecting imshow() and the stop flag
+    mutex mutexImshow;
+    atomic_bool flagStop(false);
+
+    // Add observer to "out", then start the graph
+    // This callback displays the frame on the screen
+    auto cb = [&mutexImshow, &flagStop](const Packet &packet)->Status{
+
+        // Get cv::Mat from the packet
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        cout << packet.Timestamp() << ": RECEIVED VIDEO PACKET size = " << frameOut.size() << endl;
+
+        {
+            lock_guard<mutex> lock(mutexImshow);
+            // Display frame on screen and quit on ESC
+            cv::imshow("frameOut", frameOut);
+            if (27 == cv::waitKey(1)){
+                cout << "It's time to QUIT !" << endl;
+                flagStop = true;
+            }
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    graph.StartRun({});
+
+    // Start the camera and check that it works
+    cv::VideoCapture cap(cv::CAP_ANY);
+    if (!cap.isOpened())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    cv::Mat frameIn, frameInRGB;
+
+    // Camera loop, runs until we get flagStop == true
+    for (int i=0; !flagStop ; ++i){
+        // Read next frame from camera
+        cap.read(frameIn);
+        if (frameIn.empty())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+
+        {
+            lock_guard<mutex> lock(mutexImshow);
+            cv::imshow("frameIn", frameIn);
+        }
+
+        // Convert it to a packet and send
+        cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+        ImageFrame *inputFrame =  new ImageFrame(
+            ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary
+        );
+        frameInRGB.copyTo(formats::MatView(inputFrame));
+        Timestamp ts(i);
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in",
+            Adopt(inputFrame).At(ts)
+        ));
+
+        // Print executor statistics every 100 frames
+        if (i % 100 == 99) {
+            printExecutorStats(executors);
+            for (auto &p : executors)
+                p.second->ResetStats();
+        }
+    }
+    // Close the input streams, Wait for the graph to finish
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    printExecutorStats(executors);
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 4.1 : Custom executors with CPU pinning " << endl;
+    mediapipe::Status status = run();
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
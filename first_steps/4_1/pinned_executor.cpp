@@ -0,0 +1,123 @@
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include "mediapipe/examples/first_steps/4_1/pinned_executor.h"
+#include "mediapipe/examples/first_steps/4_1/pinned_executor.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    PinnedExecutor::PinnedExecutor(const std::string &name, int numThreads, const std::vector<int> &cpus) :
+            name(name), cpus(cpus), tStatsStart(Clock::now()) {
+        for (int i = 0; i < numThreads; ++i)
+            threads.emplace_back(&PinnedExecutor::workerLoop, this, i);
+    }
+
+    //==============================================================================
+    PinnedExecutor::~PinnedExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(mutexQueue);
+            flagStop = true;
+        }
+        condQueue.notify_all();
+        for (std::thread &t : threads)
+            t.join();
+    }
+
+    //==============================================================================
+    void PinnedExecutor::Schedule(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutexQueue);
+            queue.push_back(Task{std::move(task), Clock::now()});
+        }
+        condQueue.notify_one();
+    }
+
+    //==============================================================================
+    PinnedExecutorStats PinnedExecutor::GetStats() const {
+        std::lock_guard<std::mutex> lock(mutexQueue);
+        PinnedExecutorStats stats;
+        stats.numThreads = threads.size();
+        stats.numTasks = numTasks;
+        stats.queueSize = queue.size();
+        double wallSec = std::chrono::duration<double>(Clock::now() - tStatsStart).count();
+        if (wallSec > 0 && !threads.empty())
+            stats.utilization = busySec / (wallSec * threads.size());
+        if (numTasks > 0)
+            stats.queueWaitAvgMs = 1000. * waitSumSec / numTasks;
+        stats.queueWaitMaxMs = 1000. * waitMaxSec;
+        return stats;
+    }
+
+    //==============================================================================
+    void PinnedExecutor::ResetStats() {
+        std::lock_guard<std::mutex> lock(mutexQueue);
+        tStatsStart = Clock::now();
+        numTasks = 0;
+        busySec = waitSumSec = waitMaxSec = 0;
+    }
+
+    //==============================================================================
+    void PinnedExecutor::workerLoop(int idx) {
+        using namespace std;
+        // Pin this thread to the allowed cores, it can run on any of them
+        if (!cpus.empty()) {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            for (int c : cpus)
+                CPU_SET(c, &cpuSet);
+            int err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+            if (err != 0)
+                cerr << "PinnedExecutor " << name << " : cannot pin thread " << idx << ", error " << err << endl;
+        }
+
+        for (;;) {
+            Task task;
+            {
+                unique_lock<mutex> lock(mutexQueue);
+                condQueue.wait(lock, [this] { return flagStop || !queue.empty(); });
+                // Finish all remaining tasks before quitting
+                if (queue.empty())
+                    return;
+                task = move(queue.front());
+                queue.pop_front();
+            }
+            Clock::time_point tStart = Clock::now();
+            task.fn();
+            Clock::time_point tEnd = Clock::now();
+
+            double waitSec = chrono::duration<double>(tStart - task.tSchedule).count();
+            double runSec = chrono::duration<double>(tEnd - tStart).count();
+            lock_guard<mutex> lock(mutexQueue);
+            numTasks++;
+            busySec += runSec;
+            waitSumSec += waitSec;
+            waitMaxSec = max(waitMaxSec, waitSec);
+        }
+    }
+
+    //==============================================================================
+    Status SetUpPinnedExecutors(CalculatorGraphConfig *config, CalculatorGraph *graph,
+                                std::map<std::string, std::shared_ptr<PinnedExecutor>> *executors) {
+        using namespace std;
+        for (int i = 0; i < config->executor_size(); ++i) {
+            ExecutorConfig *ec = config->mutable_executor(i);
+            if (ec->type() != "PinnedExecutor")
+                continue;
+            const PinnedExecutorOptions &options = ec->options().GetExtension(PinnedExecutorOptions::ext);
+            if (options.num_threads() < 1)
+                return absl::InvalidArgumentError("PinnedExecutor " + ec->name() + " : num_threads must be >= 1 !");
+            vector<int> cpus(options.cpu().begin(), options.cpu().end());
+            auto executor = make_shared<PinnedExecutor>(ec->name(), options.num_threads(), cpus);
+            MP_RETURN_IF_ERROR(graph->SetExecutor(ec->name(), executor));
+            (*executors)[ec->name()] = executor;
+            // MP complains if an executor given via SetExecutor() has a type in the config
+            ec->clear_type();
+            ec->clear_options();
+        }
+        return OkStatus();
+    }
+}
+//==============================================================================
@@ -0,0 +1,93 @@
+#pragma once
+// Our first header file: main.cpp needs to see PinnedExecutor to print its statistics
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/executor.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Statistics of a PinnedExecutor, since the start or the last ResetStats()
+    struct PinnedExecutorStats {
+        int numThreads = 0;
+        /// Number of finished tasks
+        uint64 numTasks = 0;
+        /// Number of tasks waiting in the queue right now
+        int queueSize = 0;
+        /// Busy time of all threads / (wall time * numThreads), 0 .. 1
+        double utilization = 0;
+        /// Time between Schedule() and the task start, in ms
+        double queueWaitAvgMs = 0;
+        double queueWaitMaxMs = 0;
+    };
+
+    /// A thread pool executor, where all threads are pinned to a set of CPU cores
+    /// An executor is what actually runs the calculator nodes (Process() calls etc.)
+    /// MP calls Schedule() for every piece of work, and we run it on one of our threads
+    class PinnedExecutor : public Executor {
+    public:
+        /// Start numThreads threads, pinned to cpus (empty = no pinning)
+        PinnedExecutor(const std::string &name, int numThreads, const std::vector<int> &cpus);
+
+        /// Finish all queued tasks, then join the threads
+        ~PinnedExecutor() override;
+
+        /// Called by MP to run a task on this executor
+        void Schedule(std::function<void()> task) override;
+
+        PinnedExecutorStats GetStats() const;
+
+        void ResetStats();
+
+        const std::string &GetName() const { return name; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        /// A task with the time it was scheduled
+        struct Task {
+            std::function<void()> fn;
+            Clock::time_point tSchedule;
+        };
+
+        /// The loop of each worker thread
+        void workerLoop(int idx);
+
+        std::string name;
+        std::vector<int> cpus;
+        std::vector<std::thread> threads;
+
+        /// Mutex protecting everything below
+        mutable std::mutex mutexQueue;
+        std::condition_variable condQueue;
+        std::deque<Task> queue;
+        bool flagStop = false;
+
+        // Statistics
+        Clock::time_point tStatsStart;
+        uint64 numTasks = 0;
+        double busySec = 0;
+        double waitSumSec = 0;
+        double waitMaxSec = 0;
+    };
+
+    /// Graph-level executor setup
+    /// Finds all executors of type "PinnedExecutor" in config, creates them from their
+    /// PinnedExecutorOptions and gives them to the graph with SetExecutor()
+    /// MP does not allow "type" for such executors, so type and options are removed from config
+    /// Must be called before graph->Initialize()
+    Status SetUpPinnedExecutors(CalculatorGraphConfig *config, CalculatorGraph *graph,
+                                std::map<std::string, std::shared_ptr<PinnedExecutor>> *executors);
+}
+//==============================================================================
@@ -0,0 +1,66 @@
+#include <iostream>
+#include <string>
+#include <memory>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/4_2/param_channel.h"
+
+//==============================================================================
+namespace mediapipe{
+    /// GoblinCalculator15 with live parameters
+    /// Applies f(x) = a*x + b, where a and b can be changed while the graph is running
+    /// Side packet A is the initial a (as in 1.5)
+    /// Side packet PARAMS is a ParamChannel, we subscribe to parameters "a" and "b" there
+    class GoblinCalculator42 : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            using namespace std;
+            cc->Inputs().Index(0).Set<double>();
+            cc->Outputs().Index(0).Set<double>();
+            // Side packets, now with tags
+            cc->InputSidePackets().Tag("A").Set<double>();
+            cc->InputSidePackets().Tag("PARAMS").Set<shared_ptr<ParamChannel>>();
+            return OkStatus();
+        }
+
+        /// Side packets are read only once, here
+        Status Open(CalculatorContext *cc) override {
+            using namespace std;
+            a = cc->InputSidePackets().Tag("A").Get<double>();
+            auto channel = cc->InputSidePackets().Tag("PARAMS").Get<shared_ptr<ParamChannel>>();
+            // Subscribe, the side packet values become the defaults
+            // If somebody already published "a" or "b", we get the published values instead
+            params = ParamSubscriber(channel, {{"a", a}, {"b", b}});
+            a = params.Get(0);
+            b = params.Get(1);
+            cout << "GoblinCalculator42::Open() : a = " << a << ", b = " << b << endl;
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            using namespace std;
+            // Pick up the latest parameters: no locks, no graph restart
+            // This costs a single atomic load when nothing changed
+            if (params.Update()) {
+                a = params.Get(0);
+                b = params.Get(1);
+                cout << "GoblinCalculator42::Process() : NEW PARAMS a = " << a << ", b = " << b << endl;
+            }
+            // Receive the input packet, extract double
+            double x = cc->Inputs().Index(0).Get<double>();
+            // Process the number
+            double y = x * a + b;
+            // Create the output packet, then send
+            Packet pOut = MakePacket<double>(y).At(cc->InputTimestamp());
+            cc->Outputs().Index(0).AddPacket(pOut);
+            return OkStatus();
+        }
+    private:
+        ParamSubscriber params;
+        double a=2, b=0;
+    };
+
+     REGISTER_CALCULATOR(GoblinCalculator42);
+}
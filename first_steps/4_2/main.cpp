@@ -0,0 +1,96 @@
+/// Example 4.2 : Live parameter updates
+/// By Oleksiy Grechnyev, IT-JIM
+/// In 1.5, parameter a came from a side packet, which is read once in Open()
+/// To change it, we have to stop the graph and start it again, which can be slow for big graphs
+/// Here we create a ParamChannel (see param_channel.h), a table of named parameters
+/// The channel itself is given to the calculator as a side packet
+/// Calculator GoblinCalculator42 subscribes to parameters "a" and "b" in Open()
+/// and picks up new values at the next Process(), without any locks
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <thread>
+#include <chrono>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/4_2/param_channel.h"
+
+//==============================================================================
+mediapipe::Status run(){
+    using namespace std;
+    using namespace mediapipe;
+    // The graph from 1.5, with one extra side packet "params"
+    string protoG = R"(
+    input_stream: "in"
+    output_stream: "out"
+    input_side_packet : "a"
+    input_side_packet : "params"
+    node {
+        calculator: "GoblinCalculator42"
+        input_side_packet : "A:a"
+        input_side_packet : "PARAMS:params"
+        input_stream: "in"
+        output_stream: "out"
+    }
+    )";
+
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+
+    // Create MP Graph and intialize it with config
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    // Add observer to "out:
+    auto cb = [](const Packet &packet)->Status{
+        cout << packet.Timestamp() << ": RECEIVED PACKET " << packet.Get<double>() << endl;
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+
+    // The channel lives in a shared_ptr: both we and the calculator keep it
+    shared_ptr<ParamChannel> channel = make_shared<ParamChannel>();
+    Packet sideA = MakePacket<double>(7.0);
+    Packet sideParams = MakePacket<shared_ptr<ParamChannel>>(channel);
+    MP_RETURN_IF_ERROR(graph.StartRun({{"a", sideA}, {"params", sideParams}}));
+
+    // Send input packets to the graph, stream "in", then close it
+    for (int i=0; i<13; ++i) {
+        // Change the parameters while the graph is running
+        // a and b are published together, the calculator never sees the new a with the old b
+        // The graph is asynchronous, so the new values apply at the next Process() after Publish(),
+        // which is not necessarily packet 5 or 10
+        if (i == 5)
+            channel->Publish({{"a", 10.0}, {"b", 1.0}});
+        else if (i == 10)
+            channel->Publish({{"a", -1.0}, {"b", 0.0}});
+
+        Timestamp ts(i);
+        Packet packet = MakePacket<double>(i*0.1).At(ts);
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", packet));
+        // Slow down a bit, so that the parameter changes are easier to see
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    graph.CloseInputStream("in");
+
+    // Wait for the graph to finish
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return OkStatus();
+}
+
+//==============================================================================
+int main(){
+    using namespace std;
+    cout << "Example 4.2 : Live parameter updates" << endl;
+    // Call run(), which return a status
+    mediapipe::Status status = run();
+    cout << "status = " << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "mediapipe/examples/first_steps/4_2/param_channel.h"
+
+//==============================================================================
+namespace mediapipe {
+    int ParamChannel::Find(const std::string &name, double initValue) {
+        std::lock_guard<std::mutex> lock(mutexWrite);
+        auto it = names.find(name);
+        if (it != names.end())
+            return it->second;
+        int n = names.size();
+        if (n >= kMaxParams)
+            return -1;
+        // Nobody reads params[n] yet, so no need to bump the version
+        params[n].store(initValue, std::memory_order_relaxed);
+        names[name] = n;
+        return n;
+    }
+
+    //==============================================================================
+    void ParamChannel::Publish(const std::map<std::string, double> &values) {
+        // Find the indices first: Find() takes the same mutex
+        std::vector<std::pair<int, double>> updates;
+        for (const auto &p : values) {
+            int i = Find(p.first, p.second);
+            if (i >= 0)
+                updates.emplace_back(i, p.second);
+        }
+
+        std::lock_guard<std::mutex> lock(mutexWrite);
+        // Odd version: update in progress
+        uint64 v = version.load(std::memory_order_relaxed);
+        version.store(v + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (const auto &u : updates)
+            params[u.first].store(u.second, std::memory_order_relaxed);
+        // Even version: done
+        version.store(v + 2, std::memory_order_release);
+    }
+
+    //==============================================================================
+    uint64 ParamChannel::Read(const std::vector<int> &idx, std::vector<double> *values) const {
+        values->resize(idx.size(), 0.);
+        for (;;) {
+            uint64 v1 = version.load(std::memory_order_acquire);
+            if (v1 & 1)
+                continue;  // A writer is busy, it will finish very soon
+            for (size_t i = 0; i < idx.size(); ++i)
+                if (idx[i] >= 0)
+                    (*values)[i] = params[idx[i]].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64 v2 = version.load(std::memory_order_relaxed);
+            if (v1 == v2)
+                return v1;
+        }
+    }
+
+    //==============================================================================
+    ParamSubscriber::ParamSubscriber(std::shared_ptr<ParamChannel> channel,
+                                     const std::vector<std::pair<std::string, double>> &namesDefaults) :
+            channel(channel) {
+        // If the table is full, idx is -1 and the parameter keeps its default forever
+        for (const auto &p : namesDefaults) {
+            idx.push_back(channel->Find(p.first, p.second));
+            values.push_back(p.second);
+        }
+        version = channel->Read(idx, &values);
+    }
+}
+//==============================================================================
@@ -0,0 +1,78 @@
+#pragma once
+// A channel for live parameter updates, shared by main.cpp and the calculator
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "mediapipe/framework/port/integral_types.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// A table of named double parameters, which can be updated while the graph is running
+    /// Writers (Publish) take a mutex, they are rare
+    /// Readers (ParamSubscriber) never lock: it is a seqlock
+    /// The version counter is odd while an update is being written, and readers retry in this case
+    /// Several values published together are always seen together (an atomic snapshot)
+    class ParamChannel {
+    public:
+        /// The table has a fixed size, so that the values never move in memory
+        static constexpr int kMaxParams = 64;
+
+        /// Find or create the parameter, returns its index or -1 if the table is full
+        /// A new parameter gets value initValue, an existing one keeps its value
+        /// Takes a mutex, call it in Open(), not in Process()
+        int Find(const std::string &name, double initValue);
+
+        /// Publish new values for several parameters, as one snapshot
+        /// Unknown names are created
+        void Publish(const std::map<std::string, double> &values);
+
+        /// Current version, changes with every Publish()
+        uint64 Version() const { return version.load(std::memory_order_acquire); }
+
+        /// Read values[i] = value of parameter idx[i], as a consistent snapshot
+        /// Values with idx[i] < 0 are not touched
+        /// Lock-free, returns the version of the snapshot
+        uint64 Read(const std::vector<int> &idx, std::vector<double> *values) const;
+
+    private:
+        std::mutex mutexWrite;
+        std::map<std::string, int> names;
+        std::atomic<uint64> version{0};
+        std::atomic<double> params[kMaxParams];
+    };
+
+    //==============================================================================
+    /// Used by a calculator to subscribe to some parameters
+    /// Update() is the hot path: a single atomic load if nothing changed
+    class ParamSubscriber {
+    public:
+        ParamSubscriber() = default;
+
+        /// Subscribe to parameters {name, default value}, call it in Open()
+        ParamSubscriber(std::shared_ptr<ParamChannel> channel,
+                        const std::vector<std::pair<std::string, double>> &namesDefaults);
+
+        /// Fetch the new snapshot if there was a Publish(), returns true if values changed
+        bool Update() {
+            if (!channel || channel->Version() == version)
+                return false;
+            version = channel->Read(idx, &values);
+            return true;
+        }
+
+        /// Value number i (in the order of subscription)
+        double Get(int i) const { return values[i]; }
+
+    private:
+        std::shared_ptr<ParamChannel> channel;
+        std::vector<int> idx;
+        std::vector<double> values;
+        uint64 version = 0;
+    };
+}
+//==============================================================================
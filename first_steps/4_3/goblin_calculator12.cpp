@@ -0,0 +1,28 @@
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe{
+    /// GoblinCalculator12 from 1.2, the classic API, for comparison
+    class GoblinCalculator12 : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Index(0).Set<double>();
+            cc->Outputs().Index(0).Set<double>();
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            // Packet copy (refcount), Get<double>() (runtime type check), MakePacket() (allocation)
+            Packet pIn = cc->Inputs().Index(0).Value();
+            double x = pIn.Get<double>();
+            double y = x * 2;
+            Packet pOut = MakePacket<double>(y).At(cc->InputTimestamp());
+            cc->Outputs().Index(0).AddPacket(pOut);
+            return OkStatus();
+        }
+     };
+
+     REGISTER_CALCULATOR(GoblinCalculator12);
+}
+//==============================================================================
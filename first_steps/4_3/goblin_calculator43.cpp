@@ -0,0 +1,49 @@
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/4_3/typed_calculator.h"
+
+//==============================================================================
+namespace mediapipe{
+    /// GoblinCalculator12 rewritten with TypedCalculator
+    /// Template parameters: the class itself, the output type, the input types
+    /// No GetContract(), no Process(), no packets: only the math
+    class GoblinCalculator43 : public TypedCalculator<GoblinCalculator43, double, double> {
+    public:
+        Status ProcessTyped(const double &x, double *y) {
+            *y = x * 2;
+            return OkStatus();
+        }
+    };
+
+    REGISTER_CALCULATOR(GoblinCalculator43);
+
+    //==============================================================================
+    /// A typed calculator with 2 inputs and a side packet, like GoblinCalculator15
+    /// Computes f(x1, x2) = a*x1 + x2
+    /// Try to change const double & to const int & in ProcessTyped(): it will not compile
+    class GoblinSumCalculator43 : public TypedCalculator<GoblinSumCalculator43, double, double, double> {
+    public:
+        /// Extra ports (here a side packet) are added on top of the generated contract
+        static Status GetContract(CalculatorContract *cc) {
+            MP_RETURN_IF_ERROR(TypedCalculator::GetContract(cc));
+            cc->InputSidePackets().Tag("A").Set<double>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            a = cc->InputSidePackets().Tag("A").Get<double>();
+            return OkStatus();
+        }
+
+        Status ProcessTyped(const double &x1, const double &x2, double *y) {
+            *y = a * x1 + x2;
+            return OkStatus();
+        }
+    private:
+        double a = 1;
+    };
+
+    REGISTER_CALCULATOR(GoblinSumCalculator43);
+}
+//==============================================================================
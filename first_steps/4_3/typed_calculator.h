@@ -0,0 +1,79 @@
+#pragma once
+// A calculator base class with compile-time port types
+
+#include <tuple>
+#include <utility>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/logging.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Get the packet content without the type check
+    /// Only safe if the packet type is known for sure, which is the case for a calculator input:
+    /// The framework checks the type when the packet is added to the stream, and
+    /// the contract (Set<T>()) is checked against the graph at Initialize()
+    /// Packet::Get<T>() checks it all again, for every packet
+    template <typename T>
+    const T &UncheckedGet(const Packet &packet) {
+        const packet_internal::HolderBase *holder = packet_internal::GetHolder(packet);
+        DCHECK(holder != nullptr && holder->As<T>() != nullptr);
+        return static_cast<const packet_internal::Holder<T> *>(holder)->data();
+    }
+
+    /// A calculator with inputs of types In... and one output of type Out, all untagged
+    /// Derived must define the method
+    ///     Status ProcessTyped(const In &... x, Out *y);
+    /// which receives the values directly, not packets
+    /// The port types are template parameters, so Derived cannot Get<>() a wrong type:
+    /// this is a compile error now, not a runtime error
+    /// It's the "CRTP" pattern: Derived is a template parameter of its own base class
+    /// Open() and Close() can be overridden as usual
+    template <class Derived, class Out, class... In>
+    class TypedCalculator : public CalculatorBase {
+    public:
+        /// The contract is generated from the template parameters
+        static Status GetContract(CalculatorContract *cc) {
+            setInputs<0, In...>(cc);
+            cc->Outputs().Index(0).Set<Out>();
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) final {
+            return processImpl(cc, std::index_sequence_for<In...>());
+        }
+
+    private:
+        template <int I>
+        static void setInputs(CalculatorContract *cc) {}
+
+        template <int I, class T, class... Rest>
+        static void setInputs(CalculatorContract *cc) {
+            cc->Inputs().Index(I).Set<T>();
+            setInputs<I + 1, Rest...>(cc);
+        }
+
+        template <size_t... I>
+        Status processImpl(CalculatorContext *cc, std::index_sequence<I...>) {
+            // Inputs are taken by const reference: no packet copies, no refcount traffic
+            // If some input is missing at this timestamp, there is no output
+            bool empty[] = {false, cc->Inputs().Index(I).IsEmpty()...};
+            for (bool e : empty)
+                if (e)
+                    return OkStatus();
+            // The output is created directly on the heap and handed to the stream, no MakePacket()
+            Out *y = new Out();
+            Status status = static_cast<Derived *>(this)->ProcessTyped(
+                    UncheckedGet<In>(cc->Inputs().Index(I).Value())..., y);
+            if (!status.ok()) {
+                delete y;
+                return status;
+            }
+            cc->Outputs().Index(0).Add(y, cc->InputTimestamp());
+            return OkStatus();
+        }
+    };
+}
+//==============================================================================
@@ -0,0 +1,92 @@
+/// Example 4.4 : Cheap small packets with a small-object allocator
+/// By Oleksiy Grechnyev, IT-JIM
+/// Every MakePacket<double>() allocates memory for an 8-byte value, plus the packet holder and
+/// shared_ptr bookkeeping. With millions of packets per second, malloc() becomes the bottleneck
+/// We cannot change the MP Packet class (and Get<T>() stays as it is), but we can make
+/// small allocations cheap: small_alloc.cpp replaces the global operator new/delete of this
+/// binary with thread-local freelists
+/// Here we count the allocations per packet for the 1.2 graph, with the freelists off and on
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <atomic>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/4_4/small_alloc.h"
+
+//==============================================================================
+/// Run n packets through the 1.2 graph, print allocations and time per packet
+mediapipe::Status benchmark(int n, bool enable){
+    using namespace std;
+    using namespace mediapipe;
+    string protoG = R"(
+    input_stream: "in"
+    output_stream: "out"
+    node {
+        calculator: "GoblinCalculator12"
+        input_stream: "in"
+        output_stream: "out"
+    }
+    )";
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    atomic_int count(0);
+    auto cb = [&count](const Packet &packet)->Status{
+        count++;
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // Count only the packet traffic, not the graph setup
+    SmallAllocEnable(enable);
+    SmallAllocStats s1 = GetSmallAllocStats();
+    auto t1 = chrono::steady_clock::now();
+    // The ingest loop of 1.2: MakePacket<double>() is still here, unchanged
+    for (int i=0; i<n; ++i) {
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", MakePacket<double>(i*0.1).At(Timestamp(i))));
+    }
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    auto t2 = chrono::steady_clock::now();
+    SmallAllocStats s2 = GetSmallAllocStats();
+    SmallAllocEnable(false);
+
+    double ns = chrono::duration<double, nano>(t2 - t1).count() / n;
+    cout << "FREELISTS " << (enable ? "ON " : "OFF") << " : " << count << " packets"
+         << ", operator new = " << double(s2.newCalls - s1.newCalls) / n << " /packet"
+         << ", malloc = " << double(s2.mallocCalls - s1.mallocCalls) / n << " /packet"
+         << ", time = " << ns << " ns/packet" << endl;
+    return OkStatus();
+}
+
+//==============================================================================
+mediapipe::Status run(){
+    // Note: "operator new" counts both packets (input and output) plus the framework internals
+    // With the freelists on, most of them never reach malloc()
+    const int n = 1000000;
+    MP_RETURN_IF_ERROR(benchmark(n, false));
+    MP_RETURN_IF_ERROR(benchmark(n, true));
+    MP_RETURN_IF_ERROR(benchmark(n, false));
+    MP_RETURN_IF_ERROR(benchmark(n, true));
+    return mediapipe::OkStatus();
+}
+
+//==============================================================================
+int main(){
+    using namespace std;
+    cout << "Example 4.4 : Cheap small packets with a small-object allocator" << endl;
+    mediapipe::Status status = run();
+    cout << "status = " << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
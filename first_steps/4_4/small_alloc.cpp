@@ -0,0 +1,256 @@
+// Every MakePacket<double>() allocates 3 small blocks: the double, the packet holder and the
+// shared_ptr control block, and they are freed on another thread
+// We cannot change the Packet class of MP, but we can make small allocations cheap:
+// here we replace the global operator new/delete with thread-local freelists (like tcmalloc)
+// Each block has a 16-byte header with its size class, blocks up to kMaxSmall bytes are recycled
+// Packets are often allocated on one thread and freed on another, so the thread caches
+// exchange batches of blocks through a global (mutex-protected) list of batches
+// This file affects ALL allocations of the binary, not only packets
+
+#include <cstdlib>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <new>
+
+#include "mediapipe/examples/first_steps/4_4/small_alloc.h"
+
+//==============================================================================
+namespace {
+    /// Header size, keeps the 16-byte alignment of operator new
+    constexpr size_t kHeader = 16;
+    /// Size classes 16, 32, ... , kMaxSmall bytes
+    constexpr size_t kClassStep = 16;
+    constexpr size_t kMaxSmall = 128;
+    constexpr int kNumClasses = kMaxSmall / kClassStep;
+    /// Number of blocks moved between a thread and the global list at once
+    constexpr int kBatch = 64;
+    /// Magic numbers to tell pooled blocks from large ones
+    constexpr uint32 kMagicSmall = 0x5A11B10C;
+    constexpr uint32 kMagicLarge = 0x1A63B10C;
+
+    struct Header {
+        uint32 magic;
+        uint32 cls;
+        uint64 unused;
+    };
+    static_assert(sizeof(Header) == kHeader, "Bad header size !");
+
+    /// A free block: the payload (at least 16 bytes) stores 2 pointers
+    struct FreeNode {
+        FreeNode *next;       /// Next block in the list
+        FreeNode *nextBatch;  /// Next batch in the global list (for the first block of a batch)
+    };
+
+    /// Per-thread cache: trivially destructible, so it is usable in any TLS destructor
+    /// The statistics counters are per-thread too: a shared atomic would be a cache line bounced
+    /// between all allocating threads on every operator new
+    /// Only the owner thread writes them; GetSmallAllocStats(), on any thread, sums the counters of all
+    /// registered threads (relaxed loads) and the retired counts of the finished ones
+    struct ThreadCache {
+        FreeNode *head[kNumClasses];
+        int count[kNumClasses];
+        bool dead;
+        std::atomic<uint64> newCalls;
+        std::atomic<uint64> mallocCalls;
+        /// Links in the list of live threads, see CounterRegistry
+        ThreadCache *prev;
+        ThreadCache *next;
+    };
+    thread_local ThreadCache tCache;
+
+    /// Global list of batches for each size class
+    struct GlobalList {
+        std::mutex mutex;
+        FreeNode *batches = nullptr;
+    };
+    GlobalList gLists[kNumClasses];
+
+    std::atomic_bool gEnabled(false);
+
+    /// All live thread caches, for GetSmallAllocStats()
+    /// Threads register once (in ThreadCacheFlusher), the counts of finished threads are kept in retired*
+    struct CounterRegistry {
+        std::mutex mutex;
+        ThreadCache *threads = nullptr;
+        std::atomic<uint64> retiredNewCalls{0};
+        std::atomic<uint64> retiredMallocCalls{0};
+    };
+    CounterRegistry gRegistry;
+
+    /// +1 on a counter of this thread: no read-modify-write instruction, nobody else writes it
+    inline void bump(std::atomic<uint64> &counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    /// Registers the counters of this thread on first use
+    /// When the thread exits, moves its counts to the retired ones and free()s all blocks cached
+    /// by this thread (they go back to malloc, not to the global lists)
+    struct ThreadCacheFlusher {
+        ThreadCacheFlusher() {
+            std::lock_guard<std::mutex> lock(gRegistry.mutex);
+            tCache.prev = nullptr;
+            tCache.next = gRegistry.threads;
+            if (gRegistry.threads != nullptr)
+                gRegistry.threads->prev = &tCache;
+            gRegistry.threads = &tCache;
+        }
+
+        ~ThreadCacheFlusher() {
+            {
+                // Keep the counts of this thread, its TLS is going away
+                std::lock_guard<std::mutex> lock(gRegistry.mutex);
+                gRegistry.retiredNewCalls += tCache.newCalls.load(std::memory_order_relaxed);
+                gRegistry.retiredMallocCalls += tCache.mallocCalls.load(std::memory_order_relaxed);
+                if (tCache.prev != nullptr)
+                    tCache.prev->next = tCache.next;
+                else
+                    gRegistry.threads = tCache.next;
+                if (tCache.next != nullptr)
+                    tCache.next->prev = tCache.prev;
+            }
+            for (int c = 0; c < kNumClasses; ++c) {
+                FreeNode *n = tCache.head[c];
+                while (n != nullptr) {
+                    FreeNode *next = n->next;
+                    std::free(reinterpret_cast<char *>(n) - kHeader);
+                    n = next;
+                }
+                tCache.head[c] = nullptr;
+                tCache.count[c] = 0;
+            }
+            tCache.dead = true;
+        }
+    };
+    thread_local ThreadCacheFlusher tFlusher;
+
+    //==============================================================================
+    /// Move one batch from this thread to the global list
+    void pushBatch(int c) {
+        FreeNode *first = tCache.head[c];
+        FreeNode *last = first;
+        for (int i = 1; i < kBatch; ++i)
+            last = last->next;
+        tCache.head[c] = last->next;
+        tCache.count[c] -= kBatch;
+        last->next = nullptr;
+
+        std::lock_guard<std::mutex> lock(gLists[c].mutex);
+        first->nextBatch = gLists[c].batches;
+        gLists[c].batches = first;
+    }
+
+    /// Move one batch from the global list to this (empty) thread cache, returns false if none
+    bool popBatch(int c) {
+        std::lock_guard<std::mutex> lock(gLists[c].mutex);
+        FreeNode *first = gLists[c].batches;
+        if (first == nullptr)
+            return false;
+        gLists[c].batches = first->nextBatch;
+        tCache.head[c] = first;
+        tCache.count[c] = kBatch;
+        return true;
+    }
+
+    //==============================================================================
+    void *smallAlloc(size_t size) {
+        bool dead = tCache.dead;
+        if (!dead) {
+            // Make sure the flusher exists in this thread (it also registers the counters)
+            (void) &tFlusher;
+            bump(tCache.newCalls);
+        } else {
+            // Allocations in TLS destructors after ours, rare
+            gRegistry.retiredNewCalls.fetch_add(1, std::memory_order_relaxed);
+        }
+        bool small = size <= kMaxSmall && gEnabled.load(std::memory_order_relaxed) && !dead;
+        int c = size == 0 ? 0 : (size - 1) / kClassStep;
+        if (small) {
+            if (tCache.head[c] != nullptr || popBatch(c)) {
+                FreeNode *n = tCache.head[c];
+                tCache.head[c] = n->next;
+                tCache.count[c]--;
+                return n;
+            }
+        }
+        // Miss: a new block from malloc, small blocks are allocated with the full class size
+        size_t payload = small ? (c + 1) * kClassStep : size;
+        Header *h = static_cast<Header *>(std::malloc(kHeader + payload));
+        if (h == nullptr)
+            throw std::bad_alloc();
+        if (!dead)
+            bump(tCache.mallocCalls);
+        else
+            gRegistry.retiredMallocCalls.fetch_add(1, std::memory_order_relaxed);
+        h->magic = small ? kMagicSmall : kMagicLarge;
+        h->cls = c;
+        return reinterpret_cast<char *>(h) + kHeader;
+    }
+
+    void smallFree(void *ptr) {
+        if (ptr == nullptr)
+            return;
+        Header *h = reinterpret_cast<Header *>(static_cast<char *>(ptr) - kHeader);
+        if (h->magic == kMagicSmall && gEnabled.load(std::memory_order_relaxed) && !tCache.dead) {
+            (void) &tFlusher;
+            int c = h->cls;
+            FreeNode *n = static_cast<FreeNode *>(ptr);
+            n->next = tCache.head[c];
+            tCache.head[c] = n;
+            tCache.count[c]++;
+            // Too many blocks here: they were probably allocated by another thread, send them back
+            if (tCache.count[c] >= 2 * kBatch)
+                pushBatch(c);
+            return;
+        }
+        std::free(h);
+    }
+}
+
+//==============================================================================
+namespace mediapipe {
+    void SmallAllocEnable(bool enable) {
+        gEnabled = enable;
+    }
+
+    SmallAllocStats GetSmallAllocStats() {
+        // Sum over the finished and the live threads
+        SmallAllocStats stats;
+        std::lock_guard<std::mutex> lock(gRegistry.mutex);
+        stats.newCalls = gRegistry.retiredNewCalls.load();
+        stats.mallocCalls = gRegistry.retiredMallocCalls.load();
+        for (const ThreadCache *t = gRegistry.threads; t != nullptr; t = t->next) {
+            stats.newCalls += t->newCalls.load(std::memory_order_relaxed);
+            stats.mallocCalls += t->mallocCalls.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+}
+
+//==============================================================================
+// The replacement operators, all plain and nothrow versions
+// The aligned (std::align_val_t) versions are not replaced, they use aligned_alloc() and free()
+void *operator new(size_t size) { return smallAlloc(size); }
+void *operator new[](size_t size) { return smallAlloc(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return smallAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return smallAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void operator delete(void *ptr) noexcept { smallFree(ptr); }
+void operator delete[](void *ptr) noexcept { smallFree(ptr); }
+void operator delete(void *ptr, size_t) noexcept { smallFree(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { smallFree(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { smallFree(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { smallFree(ptr); }
+//==============================================================================
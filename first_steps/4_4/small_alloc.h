@@ -0,0 +1,22 @@
+#pragma once
+// Small-object allocator: a replacement of the global operator new/delete for this binary
+
+#include "mediapipe/framework/port/integral_types.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Allocation statistics, since the program start
+    struct SmallAllocStats {
+        /// Calls of operator new (any size)
+        uint64 newCalls = 0;
+        /// Calls of malloc() made by operator new, i.e. the ones not served from the freelists
+        uint64 mallocCalls = 0;
+    };
+
+    /// Turn the freelists on or off at runtime (off by default)
+    /// When off, every operator new is a malloc() and every delete is a free()
+    void SmallAllocEnable(bool enable);
+
+    SmallAllocStats GetSmallAllocStats();
+}
+//==============================================================================
@@ -0,0 +1,136 @@
+#include <iostream>
+#include <string>
+#include <map>
+#include <chrono>
+#include <algorithm>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/4_5/eager_string_join_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe{
+    /// StringJoinCalculator from 1.3, which does not wait for the slower stream
+    /// Use it with ImmediateInputStreamHandler: Process() is called as soon as ANY input has a packet
+    /// We keep the halves of unfinished joins ourselves, and emit a join when:
+    /// 1) Both halves are here, or
+    /// 2) The other stream has already moved past this timestamp (the half will never come), or
+    /// 3) The first half waits longer than wait_deadline_ms
+    /// Joins are always emitted in timestamp order, a half arriving after its join was emitted is dropped
+    /// After each Process() we also advance the output timestamp bound, so that downstream
+    /// nodes know as early as possible that there will be no output below it
+    /// Note: there are no timers in a calculator, the deadline is checked when Process() is called
+    class EagerStringJoinCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Get("STR", 0).Set<std::string>();
+            cc->Inputs().Get("STR", 1).Set<std::string>();
+            cc->Outputs().Tag("STR").Set<std::string>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            waitDeadlineSec = cc->Options<EagerStringJoinCalculatorOptions>().wait_deadline_ms() / 1000.;
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            using namespace std;
+            // Store the new halves
+            Clock::time_point now = Clock::now();
+            for (int k = 0; k < 2; ++k) {
+                const InputStreamShard &in = cc->Inputs().Get("STR", k);
+                if (in.IsEmpty())
+                    continue;
+                Timestamp ts = in.Value().Timestamp();
+                // Packets of a stream come in timestamp order, so nothing below ts will ever come on k
+                lastSeen[k] = ts;
+                if (lastEmitted != Timestamp::Unset() && ts <= lastEmitted) {
+                    numLate++;
+                    continue;
+                }
+                Pending &p = pending[ts];
+                if (!p.has[0] && !p.has[1])
+                    p.tFirst = now;
+                p.has[k] = true;
+                p.s[k] = in.Get<string>();
+            }
+            emitReady(cc, now, false);
+            return OkStatus();
+        }
+
+        Status Close(CalculatorContext *cc) override {
+            using namespace std;
+            // Inputs are done: everything left is final
+            emitReady(cc, Clock::now(), true);
+            cout << "EagerStringJoinCalculator::Close() : full joins = " << numFull << ", half joins = "
+                 << numHalf << ", late halves dropped = " << numLate << endl;
+            return OkStatus();
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        /// Halves of one join, for one timestamp
+        struct Pending {
+            bool has[2] = {false, false};
+            std::string s[2];
+            Clock::time_point tFirst;
+        };
+
+        /// Emit all joins that are ready, in timestamp order, then set the timestamp bound
+        void emitReady(CalculatorContext *cc, Clock::time_point now, bool flush) {
+            using namespace std;
+            while (!pending.empty()) {
+                Timestamp ts = pending.begin()->first;
+                Pending &p = pending.begin()->second;
+                bool ready = flush || (p.has[0] && p.has[1]);
+                for (int k = 0; k < 2; ++k)
+                    if (!p.has[k] && (cc->Inputs().Get("STR", k).IsDone() ||
+                                      (lastSeen[k] != Timestamp::Unset() && lastSeen[k] > ts)))
+                        ready = true;
+                if (waitDeadlineSec >= 0 && chrono::duration<double>(now - p.tFirst).count() > waitDeadlineSec)
+                    ready = true;
+                if (!ready)
+                    break;
+
+                string s1 = p.has[0] ? p.s[0] : "<EMPTY>";
+                string s2 = p.has[1] ? p.s[1] : "<EMPTY>";
+                if (p.has[0] && p.has[1])
+                    numFull++;
+                else
+                    numHalf++;
+                cc->Outputs().Tag("STR").Add(new string(s1 + s2), ts);
+                lastEmitted = ts;
+                pending.erase(pending.begin());
+            }
+
+            // The next output cannot be below the oldest pending join,
+            // nor below the next packet of any input stream
+            Timestamp bound = Timestamp::Max();
+            if (!pending.empty())
+                bound = pending.begin()->first;
+            for (int k = 0; k < 2; ++k) {
+                if (cc->Inputs().Get("STR", k).IsDone())
+                    continue;
+                if (lastSeen[k] == Timestamp::Unset())
+                    return;  // Stream k can still send anything, no bound yet
+                bound = min(bound, lastSeen[k].NextAllowedInStream());
+            }
+            if (lastEmitted != Timestamp::Unset())
+                bound = max(bound, lastEmitted.NextAllowedInStream());
+            if (bound != Timestamp::Max())
+                cc->Outputs().Tag("STR").SetNextTimestampBound(bound);
+        }
+
+        std::map<Timestamp, Pending> pending;
+        Timestamp lastSeen[2] = {Timestamp::Unset(), Timestamp::Unset()};
+        Timestamp lastEmitted = Timestamp::Unset();
+        double waitDeadlineSec = 0;
+        int numFull = 0, numHalf = 0, numLate = 0;
+    };
+
+    REGISTER_CALCULATOR(EagerStringJoinCalculator);
+}
+//==============================================================================
@@ -0,0 +1,45 @@
+#include <string>
+#include <chrono>
+#include <thread>
+#include <random>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe{
+    /// StringSourceCalculator from 1.3, but slow and irregular, like a real sensor
+    /// Sends N packets (side packet N) with timestamps 0 .. N-1,
+    /// waiting a random time of 0 .. 20 ms before each packet
+    class JitterySourceCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->InputSidePackets().Tag("N").Set<int>();
+            cc->Outputs().Tag("STR").Set<std::string>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            n = cc->InputSidePackets().Tag("N").Get<int>();
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            using namespace std;
+            if (t >= n)
+                return tool::StatusStop();
+            // A fixed seed, so that every run gets the same delays
+            this_thread::sleep_for(chrono::milliseconds(uniform_int_distribution<int>(0, 20)(rng)));
+            cc->Outputs().Tag("STR").Add(new string("JESSICA" + to_string(t)), Timestamp(t));
+            t++;
+            return OkStatus();
+        }
+    private:
+        int n = 0;
+        int t = 0;
+        std::mt19937 rng{2021};
+    };
+
+    REGISTER_CALCULATOR(JitterySourceCalculator);
+}
+//==============================================================================
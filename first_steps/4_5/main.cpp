@@ -0,0 +1,137 @@
+/// Example 4.5 : Eager join with timestamp bounds and a wait deadline
+/// By Oleksiy Grechnyev, IT-JIM
+/// In 1.3, StringJoinCalculator joins streams "in" and "gen"
+/// With the default input stream handler, Process() for timestamp t is called only when
+/// BOTH streams have settled t, so "out" is always as late as the slower stream
+/// Here "gen" comes from JitterySourceCalculator, a slow and irregular source
+/// We compare the classic StringJoinCalculator with EagerStringJoinCalculator, which uses
+/// ImmediateInputStreamHandler, emits joins as early as possible and waits at most
+/// wait_deadline_ms for the missing half of a join
+/// For each run we measure the latency: time from adding a packet to "in" to receiving "out"
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+/// Run the join graph with the given join node, print latency statistics
+mediapipe::Status runJoin(const std::string &title, const std::string &protoJoinNode){
+    using namespace std;
+    using namespace mediapipe;
+    cout << "======== " << title << endl;
+    // The graph from 1.3 (graph1_3.pbtxt) with a slow source, the join node is inserted as a string
+    string protoG = R"(
+    input_stream: "in"
+    output_stream: "out"
+    input_side_packet: "n"
+    node {
+        calculator: "JitterySourceCalculator"
+        input_side_packet: "N:n"
+        output_stream: "STR:gen"
+    }
+    )" + protoJoinNode;
+
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    // Time when each "in" packet was sent, by timestamp
+    using Clock = chrono::steady_clock;
+    mutex mutexTimes;
+    map<int64, Clock::time_point> tSent;
+    vector<double> latenciesMs;
+
+    auto cb = [&mutexTimes, &tSent, &latenciesMs](const Packet &packet)->Status{
+        Clock::time_point now = Clock::now();
+        lock_guard<mutex> lock(mutexTimes);
+        auto it = tSent.find(packet.Timestamp().Value());
+        if (it != tSent.end())
+            latenciesMs.push_back(chrono::duration<double, milli>(now - it->second).count());
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+
+    const int n = 200;
+    MP_RETURN_IF_ERROR(graph.StartRun({{"n", MakePacket<int>(n)}}));
+
+    // Send "in" packets every 10 ms, with the time shift of 1.3
+    int tShift = -2;
+    for (int i=0; i<n; ++i) {
+        Timestamp ts(i + tShift);
+        {
+            lock_guard<mutex> lock(mutexTimes);
+            tSent[ts.Value()] = Clock::now();
+        }
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", MakePacket<string>("BRIANNA" + to_string(i)).At(ts)));
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+
+    // Statistics
+    if (latenciesMs.empty())
+        return absl::InternalError("No output !");
+    sort(latenciesMs.begin(), latenciesMs.end());
+    double sum = 0;
+    for (double l : latenciesMs)
+        sum += l;
+    cout << "LATENCY : " << latenciesMs.size() << " packets, avg = " << sum / latenciesMs.size()
+         << " ms, median = " << latenciesMs[latenciesMs.size() / 2] << " ms, max = " << latenciesMs.back() << " ms" << endl;
+    return OkStatus();
+}
+
+//==============================================================================
+mediapipe::Status run(){
+    using namespace std;
+    // Classic: default input stream handler, waits for both streams
+    MP_RETURN_IF_ERROR(runJoin("CLASSIC StringJoinCalculator", R"(
+    node {
+        calculator: "StringJoinCalculator"
+        input_stream: "STR:0:in"
+        input_stream: "STR:1:gen"
+        output_stream: "STR:out"
+    }
+    )"));
+
+    // Eager: the input stream handler is set per node
+    // Try to change wait_deadline_ms: 0 never waits, -1 waits as long as the classic one
+    MP_RETURN_IF_ERROR(runJoin("EAGER EagerStringJoinCalculator", R"(
+    node {
+        calculator: "EagerStringJoinCalculator"
+        input_stream: "STR:0:in"
+        input_stream: "STR:1:gen"
+        output_stream: "STR:out"
+        input_stream_handler {
+            input_stream_handler: "ImmediateInputStreamHandler"
+        }
+        options : {
+            [mediapipe.EagerStringJoinCalculatorOptions.ext]{
+                wait_deadline_ms: 5.0
+            }
+        }
+    }
+    )"));
+    return mediapipe::OkStatus();
+}
+
+//==============================================================================
+int main(){
+    using namespace std;
+    cout << "Example 4.5 : Eager join with timestamp bounds and a wait deadline" << endl;
+    mediapipe::Status status = run();
+    cout << "status = " << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe{
+    /// Joins any number of input streams into one output
+    /// With the default input stream handler, Process() waits for all inputs at each timestamp,
+    /// then the packet of input 0 is sent on
+    /// This is the "fan-in" node of our benchmark DAGs
+    class FanInCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            // Any number of inputs of any type, all of the same type as input 0
+            cc->Inputs().Index(0).SetAny();
+            for (int i = 1; i < cc->Inputs().NumEntries(); ++i)
+                cc->Inputs().Index(i).SetSameAs(&cc->Inputs().Index(0));
+            cc->Outputs().Index(0).SetSameAs(&cc->Inputs().Index(0));
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            cc->Outputs().Index(0).AddPacket(cc->Inputs().Index(0).Value());
+            return OkStatus();
+        }
+    };
+
+    REGISTER_CALCULATOR(FanInCalculator);
+}
+//==============================================================================
@@ -0,0 +1,125 @@
+/// Example 4.6 : Framework overhead benchmark
+/// By Oleksiy Grechnyev, IT-JIM
+/// The graph of 1.1, a chain of PassThroughCalculator nodes, does nothing at all,
+/// so its run time is pure MP overhead: scheduling, queues, timestamps, packet copies
+/// Here we generate bigger graphs of this kind and measure them:
+/// 1) Chains of depth D: in -> PassThrough -> PassThrough -> ... -> out
+/// 2) DAGs of depth D and width W: each stage is a fan-out to W PassThrough nodes,
+///    then a fan-in back to one stream with FanInCalculator (fan_in_calculator.cpp)
+/// For each graph and executor thread count we print ns per hop and packets/sec
+/// A "hop" is one Process() call of one node for one packet
+/// Build with -c opt, and use these numbers as the baseline for any framework tuning
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+/// Generate a graph config: depth stages of width PassThrough nodes each
+/// width == 1 means a plain chain (no fan-in nodes), numHops is set to the hops per packet
+std::string makeGraph(int depth, int width, int numThreads, int *numHops) {
+    using namespace std;
+    string proto = "input_stream: \"in\"\noutput_stream: \"out\"\nnum_threads: " + to_string(numThreads) + "\n";
+    string prev = "in";
+    *numHops = 0;
+    for (int d = 0; d < depth; ++d) {
+        string next = (d == depth - 1) ? "out" : "s" + to_string(d);
+        if (width == 1) {
+            proto += "node { calculator: \"PassThroughCalculator\" input_stream: \"" + prev +
+                     "\" output_stream: \"" + next + "\" }\n";
+            *numHops += 1;
+        } else {
+            // Fan-out: width nodes read the same stream prev
+            string fanIn = "node { calculator: \"FanInCalculator\" ";
+            for (int w = 0; w < width; ++w) {
+                string branch = "s" + to_string(d) + "_" + to_string(w);
+                proto += "node { calculator: \"PassThroughCalculator\" input_stream: \"" + prev +
+                         "\" output_stream: \"" + branch + "\" }\n";
+                fanIn += "input_stream: \"" + branch + "\" ";
+            }
+            // Fan-in: one node reads all branches
+            proto += fanIn + "output_stream: \"" + next + "\" }\n";
+            *numHops += width + 1;
+        }
+        prev = next;
+    }
+    return proto;
+}
+
+//==============================================================================
+/// Run n packets through the generated graph, print the results
+mediapipe::Status benchmark(int depth, int width, int numThreads, int n){
+    using namespace std;
+    using namespace mediapipe;
+    int numHops;
+    string protoG = makeGraph(depth, width, numThreads, &numHops);
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    atomic_int count(0);
+    auto cb = [&count](const Packet &packet)->Status{
+        count++;
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // The packets are created in advance, so that we measure only the graph
+    vector<Packet> packets;
+    packets.reserve(n);
+    for (int i=0; i<n; ++i)
+        packets.push_back(MakePacket<double>(i*0.1).At(Timestamp(i)));
+
+    auto t1 = chrono::steady_clock::now();
+    for (int i=0; i<n; ++i)
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", packets[i]));
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    auto t2 = chrono::steady_clock::now();
+
+    if (count != n)
+        return absl::InternalError("Lost packets !");
+    double sec = chrono::duration<double>(t2 - t1).count();
+    cout << "depth = " << depth << ", width = " << width << ", threads = " << numThreads
+         << ", hops/packet = " << numHops
+         << " : " << 1e9 * sec / (double(n) * numHops) << " ns/hop, "
+         << n / sec << " packets/s" << endl;
+    return OkStatus();
+}
+
+//==============================================================================
+mediapipe::Status run(){
+    // Edit these lists to your taste
+    const std::vector<int> threadList = {1, 2, 4, 8};
+    const std::vector<int> depthList = {1, 4, 16};
+    const std::vector<int> widthList = {1, 4};
+    const int n = 100000;
+
+    // Warm-up
+    MP_RETURN_IF_ERROR(benchmark(2, 1, 1, n / 10));
+    for (int width : widthList)
+        for (int depth : depthList)
+            for (int numThreads : threadList)
+                MP_RETURN_IF_ERROR(benchmark(depth, width, numThreads, n));
+    return mediapipe::OkStatus();
+}
+
+//==============================================================================
+int main(){
+    using namespace std;
+    cout << "Example 4.6 : Framework overhead benchmark" << endl;
+    mediapipe::Status status = run();
+    cout << "status = " << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,233 @@
+/// Example 4.7 : Lock-free output polling
+/// By Oleksiy Grechnyev, IT-JIM
+/// In all other examples we consume the graph outputs in ObserveOutputStream() callbacks
+/// Such a callback runs on a graph thread, so while it works (and waits for a mutex), the graph waits too
+/// Here we compare it with RingPoller (ring_poller.h): the callback only pushes the packet into
+/// a lock-free single-producer/single-consumer ring (spsc_ring.h), and our own consumer thread
+/// drains up to N packets at a time, waiting for them by busy polling, futex, or both
+/// If the consumer falls behind, the oldest packets are overwritten, and we get their count
+/// The graph is a chain of PassThrough nodes fed as fast as possible, each packet is an int64:
+/// the time when it was sent, the consumer does work_us of busy work per packet
+/// For each mode we print the graph run time, packets consumed and lost, and the latency
+/// Mode "stress" is a regression test of the ring itself, without a graph: a tiny ring which overwrites
+/// all the time, items with a slow destructor (so Push() is often caught between its steps),
+/// and we check that the consumer gets the items in order and that none is lost without being counted
+/// Usage: 4_7 [observer|busy|futex|hybrid|stress|all] [work_us=5] [capacity=256] [batch=32]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/4_7/ring_poller.h"
+
+//==============================================================================
+/// Steady clock in microseconds
+static int64 nowUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+//==============================================================================
+/// Simulated consumer work: display, network, whatever
+static void busyWork(int64 us) {
+    int64 tEnd = nowUs() + us;
+    while (nowUs() < tEnd) {}
+}
+
+//==============================================================================
+/// Consumer statistics
+struct ConsumerStats {
+    int64 consumed = 0;
+    double latencySumUs = 0;
+    int64 latencyMaxUs = 0;
+
+    void add(const mediapipe::Packet &packet) {
+        int64 latency = nowUs() - packet.Get<int64>();
+        consumed++;
+        latencySumUs += latency;
+        latencyMaxUs = std::max(latencyMaxUs, latency);
+    }
+};
+
+//==============================================================================
+/// Overwrite stress test of SpscOverwriteRing, returns an error if the order is broken
+mediapipe::Status stressRing(int n) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // An item which takes a while to destroy, like a packet holding the last reference to a big frame
+    struct SlowItem {
+        int64 value;
+        explicit SlowItem(int64 value) : value(value) {}
+        SlowItem(SlowItem &&other) = default;
+        SlowItem &operator=(SlowItem &&other) = default;
+        ~SlowItem() { this_thread::sleep_for(chrono::microseconds(50)); }
+    };
+
+    SpscOverwriteRing<SlowItem> ring(4);
+    thread producer([&ring, n] {
+        for (int i = 0; i < n; ++i)
+            ring.Push(SlowItem(i));
+        ring.Close();
+    });
+    vector<SlowItem> items;
+    int64 last = -1, received = 0, bad = 0;
+    while (ring.Wait(RingWaitMode::FUTEX, 1000000)) {
+        items.clear();
+        ring.Drain(&items, 3);
+        for (const SlowItem &item : items) {
+            if (item.value <= last) {
+                if (bad == 0)
+                    cout << "stress : out of order: " << item.value << " after " << last << endl;
+                bad++;
+            }
+            last = item.value;
+            received++;
+        }
+    }
+    producer.join();
+    cout << "stress : pushed = " << n << ", received = " << received << ", overwritten = " << ring.Overwritten()
+         << ", out of order = " << bad << endl;
+    if (bad > 0 || received + int64(ring.Overwritten()) != n)
+        return absl::InternalError("SpscOverwriteRing stress test failed !");
+    return OkStatus();
+}
+
+//==============================================================================
+/// Run the graph with one consumer mode, print the results
+mediapipe::Status benchmark(const std::string &mode, int n, int workUs, int capacity, int batch) {
+    using namespace std;
+    using namespace mediapipe;
+
+    string protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "PassThroughCalculator"
+            input_stream: "in"
+            output_stream: "s1"
+        }
+        node {
+            calculator: "PassThroughCalculator"
+            input_stream: "s1"
+            output_stream: "s2"
+        }
+        node {
+            calculator: "PassThroughCalculator"
+            input_stream: "s2"
+            output_stream: "out"
+        }
+        )";
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    ConsumerStats stats;
+    RingPoller poller(capacity);
+    mutex mutexStats;
+    thread consumer;
+    // Stop the consumer on every exit path, including the MP_RETURN_IF_ERROR ones below:
+    // destroying a joinable std::thread calls std::terminate()
+    struct ConsumerGuard {
+        RingPoller &poller;
+        thread &consumer;
+
+        ~ConsumerGuard() {
+            if (consumer.joinable()) {
+                poller.Close();
+                consumer.join();
+            }
+        }
+    } consumerGuard{poller, consumer};
+    if (mode == "observer") {
+        // The usual way: all work in the callback, under a mutex (as if shared with the GUI thread)
+        auto cb = [&stats, &mutexStats, workUs](const Packet &packet) -> Status {
+            lock_guard<mutex> lock(mutexStats);
+            busyWork(workUs);
+            stats.add(packet);
+            return OkStatus();
+        };
+        MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    } else {
+        RingWaitMode waitMode = mode == "busy" ? RingWaitMode::BUSY :
+                                (mode == "futex" ? RingWaitMode::FUTEX : RingWaitMode::HYBRID);
+        MP_RETURN_IF_ERROR(poller.Attach(&graph, "out"));
+        // The consumer thread: wait, drain a batch, work on it
+        consumer = thread([&poller, &stats, waitMode, workUs, batch] {
+            vector<Packet> packets;
+            packets.reserve(batch);
+            while (poller.Wait(waitMode, 1000000)) {
+                packets.clear();
+                poller.Drain(&packets, batch);
+                for (const Packet &p : packets) {
+                    busyWork(workUs);
+                    stats.add(p);
+                }
+            }
+        });
+    }
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    auto t1 = chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i)
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", MakePacket<int64>(nowUs()).At(Timestamp(i))));
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    auto t2 = chrono::steady_clock::now();
+    if (consumer.joinable()) {
+        poller.Close();
+        consumer.join();
+    }
+
+    double sec = chrono::duration<double>(t2 - t1).count();
+    cout << mode << " : graph " << sec << " s, " << n / sec << " packets/s, consumed = " << stats.consumed
+         << ", overwritten = " << poller.Overwritten()
+         << ", latency avg = " << (stats.consumed ? stats.latencySumUs / stats.consumed : 0)
+         << " us, max = " << stats.latencyMaxUs << " us" << endl;
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 4.7 : Lock-free output polling" << endl;
+    string mode = argc > 1 ? argv[1] : "all";
+    int workUs = argc > 2 ? stoi(argv[2]) : 5;
+    int capacity = argc > 3 ? stoi(argv[3]) : 256;
+    int batch = argc > 4 ? stoi(argv[4]) : 32;
+    const int n = 100000;
+
+    vector<string> modes = {mode};
+    if (mode == "all")
+        modes = {"observer", "busy", "futex", "hybrid", "stress"};
+    mediapipe::Status status;
+    for (const string &m : modes) {
+        if (m != "observer" && m != "busy" && m != "futex" && m != "hybrid" && m != "stress") {
+            cout << "Usage: 4_7 [observer|busy|futex|hybrid|stress|all] [work_us=5] [capacity=256] [batch=32]"
+                 << endl;
+            return 1;
+        }
+        status = m == "stress" ? stressRing(20000) : benchmark(m, n, workUs, capacity, batch);
+        if (!status.ok())
+            break;
+    }
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,15 @@
+#include "mediapipe/examples/first_steps/4_7/ring_poller.h"
+
+//==============================================================================
+namespace mediapipe {
+    Status RingPoller::Attach(CalculatorGraph *graph, const std::string &streamName) {
+        // The callback is called for one stream, in timestamp order, never concurrently,
+        // so it is the single producer of the ring
+        auto cb = [this](const Packet &packet) -> Status {
+            ring.Push(packet);
+            return OkStatus();
+        };
+        return graph->ObserveOutputStream(streamName, cb);
+    }
+}
+//==============================================================================
@@ -0,0 +1,48 @@
+#pragma once
+// Batched polling of a graph output stream through a lock-free ring, instead of observer callbacks
+
+#include <string>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/4_7/spsc_ring.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// An output stream poller, an alternative to both ObserveOutputStream() and OutputStreamPoller
+    /// The observer callback (it runs on a graph thread) only pushes the packet into SpscOverwriteRing,
+    /// which never locks or waits, all the real work happens on the consumer thread:
+    /// Wait() for packets (busy, futex or hybrid), then Drain() up to N packets at a time
+    /// If the consumer falls behind, the oldest packets are overwritten, and the graph never stalls
+    /// The poller must outlive the graph run
+    class RingPoller {
+    public:
+        /// capacity = how many packets the consumer can fall behind before losing them
+        explicit RingPoller(int capacity = 256) : ring(capacity) {}
+
+        /// Attach to an output stream of graph, call after Initialize() and before StartRun()
+        Status Attach(CalculatorGraph *graph, const std::string &streamName);
+
+        /// Wait for packets, returns false on timeout, or when closed and everything is drained
+        bool Wait(RingWaitMode mode, int64 timeoutUs) { return ring.Wait(mode, timeoutUs); }
+
+        /// Append up to maxPackets packets to out, in order, returns the number of packets
+        int Drain(std::vector<Packet> *out, int maxPackets) { return ring.Drain(out, maxPackets); }
+
+        /// Call after WaitUntilDone(): no more packets, Wait() stops waiting
+        void Close() { ring.Close(); }
+
+        /// Packets lost because the consumer was too slow
+        uint64 Overwritten() const { return ring.Overwritten(); }
+
+        /// Packets received from the graph
+        uint64 Pushed() const { return ring.Pushed(); }
+
+    private:
+        SpscOverwriteRing<Packet> ring;
+    };
+}
+//==============================================================================
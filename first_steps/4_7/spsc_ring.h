@@ -0,0 +1,190 @@
+#pragma once
+// A lock-free single-producer/single-consumer ring which overwrites the oldest items when full
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "mediapipe/framework/port/integral_types.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// How the consumer waits for new items
+    enum class RingWaitMode {
+        BUSY,    /// Spin (with a CPU pause), lowest latency, burns one core
+        FUTEX,   /// Sleep in the kernel until the producer wakes us
+        HYBRID   /// Spin for a while, then sleep
+    };
+
+    /// SPSC ring with overwriting: the producer (Push) NEVER waits, if the consumer falls behind,
+    /// its oldest unread items are lost, and the consumer learns how many (Overwritten())
+    /// Each slot holds an atomic pointer to a node {sequence number, item}, both sides take nodes
+    /// with an atomic exchange, so a node always has exactly one owner, even if the producer
+    /// overwrites the slot the consumer is reading
+    /// The sequence numbers tell the consumer which items it missed, the order is always preserved
+    /// Waiting is futex-based: the producer makes a syscall only if the consumer is asleep
+    /// T must be movable, e.g. Packet
+    template<typename T>
+    class SpscOverwriteRing {
+    public:
+        explicit SpscOverwriteRing(int capacity) : slots(capacity) {
+            for (auto &s : slots)
+                s.store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~SpscOverwriteRing() {
+            for (auto &s : slots)
+                delete s.load(std::memory_order_relaxed);
+        }
+
+        SpscOverwriteRing(const SpscOverwriteRing &) = delete;
+
+        SpscOverwriteRing &operator=(const SpscOverwriteRing &) = delete;
+
+        //==============================================================================
+        // Producer side
+
+        /// Add an item, wait-free apart from the allocation
+        void Push(T item) {
+            uint64 seq = writeSeq.load(std::memory_order_relaxed);
+            Node *node = new Node{seq, std::move(item)};
+            Node *old = slots[seq % slots.size()].exchange(node, std::memory_order_acq_rel);
+            // An unread item from a previous lap, the consumer will skip it by the sequence number
+            delete old;
+            writeSeq.store(seq + 1, std::memory_order_seq_cst);
+            wake();
+        }
+
+        /// No more items will come, wakes the consumer
+        void Close() {
+            closed.store(true, std::memory_order_seq_cst);
+            wake();
+        }
+
+        //==============================================================================
+        // Consumer side
+
+        /// Take up to maxItems items (appended to out), in order, returns the number taken
+        /// Only the item with seq == readSeq is ever delivered, and readSeq never passes the published
+        /// writeSeq, so the order holds even while Push() is between its exchange and the writeSeq store
+        int Drain(std::vector<T> *out, int maxItems) {
+            uint64 capacity = slots.size();
+            int n = 0;
+            while (n < maxItems) {
+                uint64 w = writeSeq.load(std::memory_order_acquire);
+                if (readSeq >= w)
+                    break;
+                // Item s is overwritten by item s + capacity: everything before w - capacity is gone
+                if (w - readSeq > capacity) {
+                    overwritten += w - capacity - readSeq;
+                    readSeq = w - capacity;
+                }
+                std::atomic<Node *> &slot = slots[readSeq % capacity];
+                Node *node = slot.exchange(nullptr, std::memory_order_acq_rel);
+                if (node == nullptr || node->seq < readSeq) {
+                    // Cannot happen with a single producer, but let us not loop forever
+                    delete node;
+                    overwritten++;
+                    readSeq++;
+                    continue;
+                }
+                if (node->seq > readSeq) {
+                    // The producer has lapped us after we loaded w: item readSeq is lost, and this newer
+                    // node is not our turn yet (maybe not even published), give it back to the slot
+                    // If the producer has put an even newer node there meanwhile, ours is overwritten
+                    Node *expected = nullptr;
+                    if (!slot.compare_exchange_strong(expected, node, std::memory_order_acq_rel))
+                        delete node;
+                    overwritten++;
+                    readSeq++;
+                    continue;
+                }
+                out->push_back(std::move(node->item));
+                delete node;
+                readSeq++;
+                n++;
+            }
+            return n;
+        }
+
+        /// Wait until there is something to Drain(), returns false on timeout or if closed and empty
+        bool Wait(RingWaitMode mode, int64 timeoutUs, int64 spinUs = 50) {
+            using namespace std::chrono;
+            auto tEnd = steady_clock::now() + microseconds(timeoutUs);
+            auto tSpinEnd = steady_clock::now() + microseconds(mode == RingWaitMode::HYBRID ? spinUs : 0);
+            for (;;) {
+                if (hasItems())
+                    return true;
+                if (closed.load(std::memory_order_acquire))
+                    return hasItems();
+                auto now = steady_clock::now();
+                if (now >= tEnd)
+                    return false;
+                if (mode == RingWaitMode::BUSY || now < tSpinEnd) {
+                    cpuRelax();
+                    continue;
+                }
+                // Announce that we sleep, then check again: either we see the new item,
+                // or the producer sees sleeping == true and wakes us (both are seq_cst)
+                uint32 word = futexWord.load(std::memory_order_seq_cst);
+                sleeping.store(true, std::memory_order_seq_cst);
+                if (!hasItems() && !closed.load(std::memory_order_seq_cst)) {
+                    int64 ns = duration_cast<nanoseconds>(tEnd - now).count();
+                    timespec ts{time_t(ns / 1000000000), long(ns % 1000000000)};
+                    syscall(SYS_futex, reinterpret_cast<uint32 *>(&futexWord), FUTEX_WAIT_PRIVATE, word, &ts,
+                            nullptr, 0);
+                }
+                sleeping.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        /// Items lost because the consumer was too slow
+        uint64 Overwritten() const { return overwritten; }
+
+        /// Items pushed so far
+        uint64 Pushed() const { return writeSeq.load(std::memory_order_relaxed); }
+
+    private:
+        struct Node {
+            uint64 seq;
+            T item;
+        };
+
+        bool hasItems() const {
+            return writeSeq.load(std::memory_order_seq_cst) > readSeq;
+        }
+
+        void wake() {
+            futexWord.fetch_add(1, std::memory_order_seq_cst);
+            if (sleeping.load(std::memory_order_seq_cst))
+                syscall(SYS_futex, reinterpret_cast<uint32 *>(&futexWord), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+
+        static void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#else
+            std::this_thread::yield();
+#endif
+        }
+
+        std::vector<std::atomic<Node *>> slots;
+        /// Producer and consumer data on separate cache lines, so they do not bounce between cores
+        alignas(64) std::atomic<uint64> writeSeq{0};
+        std::atomic<uint32> futexWord{0};
+        std::atomic_bool closed{false};
+        alignas(64) uint64 readSeq = 0;
+        uint64 overwritten = 0;
+        std::atomic_bool sleeping{false};
+    };
+}
+//==============================================================================
@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+#include "mediapipe/framework/calculator_profile.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+
+#include "mediapipe/examples/first_steps/4_8/graph_monitor.h"
+
+//==============================================================================
+namespace mediapipe {
+    namespace {
+        int64 nowUs() {
+            using namespace std::chrono;
+            return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        /// "TAG:0:name" or "TAG:name" or "name" -> "name"
+        std::string streamName(const std::string &spec) {
+            size_t pos = spec.rfind(':');
+            return pos == std::string::npos ? spec : spec.substr(pos + 1);
+        }
+
+        /// Tag and index of an input stream: "TAG:1:name" -> "TAG:1", "TAG:name" -> "TAG:0",
+        /// "name" -> ":<untaggedIndex>"
+        std::string specTagIndex(const std::string &spec, int untaggedIndex) {
+            size_t first = spec.find(':'), last = spec.rfind(':');
+            if (first == std::string::npos)
+                return ":" + std::to_string(untaggedIndex);
+            if (first == last)
+                return spec.substr(0, first) + ":0";
+            return spec.substr(0, last);
+        }
+
+        /// tag_index of InputStreamInfo in the same form: "TAG" -> "TAG:0"
+        std::string infoTagIndex(const std::string &tagIndex) {
+            return tagIndex.find(':') == std::string::npos ? tagIndex + ":0" : tagIndex;
+        }
+
+        /// Total count of a histogram
+        int64 histogramCount(const TimeHistogram &h) {
+            int64 n = 0;
+            for (int64 c : h.count())
+                n += c;
+            return n;
+        }
+
+        /// Payload size of the known packet types, 0 for others
+        int64 packetBytes(const Packet &packet) {
+            if (packet.ValidateAsType<ImageFrame>().ok()) {
+                const ImageFrame &frame = packet.Get<ImageFrame>();
+                return int64(frame.WidthStep()) * frame.Height();
+            }
+            if (packet.ValidateAsType<std::string>().ok())
+                return packet.Get<std::string>().size();
+            return 0;
+        }
+
+        /// Escape quotes and backslashes for both DOT and JSON strings
+        std::string escape(const std::string &s) {
+            std::string r;
+            for (char c : s) {
+                if (c == '"' || c == '\\')
+                    r.push_back('\\');
+                r.push_back(c);
+            }
+            return r;
+        }
+
+        /// x in [0, 1] -> green, yellow, red
+        std::string heatColor(double x) {
+            x = std::min(std::max(x, 0.0), 1.0);
+            int r, g;
+            if (x < 0.5) {
+                r = int(510 * x);
+                g = 180 + int(40 * x);
+            } else {
+                r = 255;
+                g = int(200 * (1 - x) * 2);
+            }
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "#%02x%02x00", r, g);
+            return buf;
+        }
+
+        /// x in [0, 1] -> white, pink
+        std::string paleColor(double x) {
+            x = std::min(std::max(x, 0.0), 1.0);
+            int gb = 255 - int(140 * x);
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "#ff%02x%02x", gb, gb);
+            return buf;
+        }
+    }
+
+    //==============================================================================
+    void GraphMonitor::Prepare(CalculatorGraphConfig *config) {
+        if (!enabled)
+            return;
+        // The profiler counts the Process() time, and with stream latency, the packets on each input
+        auto *profilerConfig = config->mutable_profiler_config();
+        profilerConfig->set_enable_profiler(true);
+        profilerConfig->set_enable_stream_latency(true);
+
+        nodes.clear();
+        edges.clear();
+        producers.clear();
+        for (const std::string &s : config->input_stream())
+            producers[streamName(s)] = "INPUT";
+        // Profiles are found by node names, so every node gets a unique one
+        for (int i = 0; i < config->node_size(); ++i) {
+            CalculatorGraphConfig::Node *node = config->mutable_node(i);
+            if (node->name().empty())
+                node->set_name(node->calculator() + "_" + std::to_string(i));
+            NodeSnapshot ns;
+            ns.name = node->name();
+            ns.calculator = node->calculator();
+            nodes.push_back(ns);
+            for (const std::string &s : node->output_stream())
+                producers[streamName(s)] = node->name();
+        }
+        for (const CalculatorGraphConfig::Node &node : config->node()) {
+            int untagged = 0;
+            for (const std::string &s : node.input_stream()) {
+                std::string ti = specTagIndex(s, untagged);
+                if (s.find(':') == std::string::npos)
+                    untagged++;
+                bool backEdge = false;
+                for (const InputStreamInfo &info : node.input_stream_info())
+                    if (info.back_edge() && infoTagIndex(info.tag_index()) == ti)
+                        backEdge = true;
+                edges.push_back(Edge{streamName(s), "", node.name(), backEdge});
+            }
+        }
+        for (const std::string &s : config->output_stream())
+            edges.push_back(Edge{streamName(s), "", "OUTPUT", false});
+        for (Edge &e : edges)
+            e.from = producers.count(e.stream) ? producers[e.stream] : "?";
+    }
+
+    //==============================================================================
+    Status GraphMonitor::Attach(CalculatorGraph *graph) {
+        if (!enabled)
+            return OkStatus();
+        this->graph = graph;
+        counters.clear();
+        // The observer callbacks only touch atomics, they do not slow the graph down much
+        for (const auto &p : producers) {
+            std::unique_ptr<StreamCounters> c(new StreamCounters);
+            StreamCounters *pc = c.get();
+            counters[p.first] = std::move(c);
+            MP_RETURN_IF_ERROR(graph->ObserveOutputStream(p.first, [pc](const Packet &packet) -> Status {
+                pc->produced++;
+                pc->bytes += packetBytes(packet);
+                return OkStatus();
+            }));
+        }
+        t0Us = prevUs = nowUs();
+        prevProduced.clear();
+        prevBusyUs.clear();
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status GraphMonitor::Snapshot(GraphSnapshot *snap) {
+        if (!enabled || graph == nullptr)
+            return absl::FailedPreconditionError("GraphMonitor is disabled or not attached !");
+        std::vector<CalculatorProfile> profiles;
+        MP_RETURN_IF_ERROR(graph->profiler()->GetCalculatorProfiles(&profiles));
+        std::map<std::string, const CalculatorProfile *> profileByName;
+        for (const CalculatorProfile &p : profiles)
+            profileByName[p.name()] = &p;
+
+        std::lock_guard<std::mutex> lock(mutexSnapshot);
+        int64 now = nowUs();
+        double dt = std::max<int64>(now - prevUs, 1) * 1e-6;
+        prevUs = now;
+        snap->timeSec = (now - t0Us) * 1e-6;
+
+        snap->nodes = nodes;
+        for (NodeSnapshot &ns : snap->nodes) {
+            auto it = profileByName.find(ns.name);
+            if (it == profileByName.end())
+                continue;
+            const TimeHistogram &runtime = it->second->process_runtime();
+            ns.processCalls = histogramCount(runtime);
+            ns.busyFraction = (runtime.total() - prevBusyUs[ns.name]) * 1e-6 / dt;
+            prevBusyUs[ns.name] = runtime.total();
+        }
+
+        snap->edges.clear();
+        for (const Edge &e : edges) {
+            EdgeSnapshot es;
+            es.stream = e.stream;
+            es.from = e.from;
+            es.to = e.to;
+            es.backEdge = e.backEdge;
+            auto itc = counters.find(e.stream);
+            int64 bytes = 0;
+            if (itc != counters.end()) {
+                es.produced = itc->second->produced;
+                bytes = itc->second->bytes;
+            }
+            // Graph outputs go to observers, their queues are not profiled
+            es.consumed = es.produced;
+            auto itp = profileByName.find(e.to);
+            if (itp != profileByName.end())
+                for (const StreamProfile &sp : itp->second->input_stream_profiles())
+                    if (sp.name() == e.stream)
+                        es.consumed = histogramCount(sp.latency());
+            es.queueDepth = std::max<int64>(es.produced - es.consumed, 0);
+            es.packetsPerSec = (es.produced - prevProduced[e.stream]) / dt;
+            es.bytesInFlight = es.produced > 0 ? double(es.queueDepth) * bytes / es.produced : 0;
+            snap->edges.push_back(es);
+        }
+        for (const auto &p : counters)
+            prevProduced[p.first] = p.second->produced;
+        return OkStatus();
+    }
+
+    //==============================================================================
+    void GraphMonitor::StartPeriodic(int periodMs, std::function<void(const GraphSnapshot &)> callback) {
+        if (!enabled)
+            return;
+        Stop();
+        flagStop = false;
+        thread = std::thread([this, periodMs, callback] {
+            std::unique_lock<std::mutex> lock(mutexStop);
+            while (!condStop.wait_for(lock, std::chrono::milliseconds(periodMs), [this] { return flagStop; })) {
+                lock.unlock();
+                GraphSnapshot snap;
+                if (Snapshot(&snap).ok())
+                    callback(snap);
+                lock.lock();
+            }
+        });
+    }
+
+    //==============================================================================
+    void GraphMonitor::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutexStop);
+            flagStop = true;
+        }
+        condStop.notify_all();
+        if (thread.joinable())
+            thread.join();
+    }
+
+    //==============================================================================
+    std::string SnapshotToDot(const GraphSnapshot &snap, int redDepth) {
+        std::ostringstream os;
+        os.precision(3);
+        os << "digraph G {\n";
+        os << "  label=\"t = " << snap.timeSec << " s\";\n";
+        os << "  node [shape=box, style=\"rounded,filled\", fontname=\"Helvetica\"];\n";
+        os << "  edge [fontname=\"Helvetica\", fontsize=10];\n";
+        os << "  \"INPUT\" [shape=ellipse, fillcolor=\"#dddddd\"];\n";
+        os << "  \"OUTPUT\" [shape=ellipse, fillcolor=\"#dddddd\"];\n";
+        for (const NodeSnapshot &n : snap.nodes)
+            os << "  \"" << escape(n.name) << "\" [label=\"" << escape(n.name) << "\\n" << escape(n.calculator)
+               << "\\nbusy " << int(100 * n.busyFraction + 0.5) << "%\", fillcolor=\""
+               << paleColor(n.busyFraction) << "\"];\n";
+        for (const EdgeSnapshot &e : snap.edges) {
+            os << "  \"" << escape(e.from) << "\" -> \"" << escape(e.to) << "\" [label=\"" << escape(e.stream)
+               << "\\nq=" << e.queueDepth << ", " << e.packetsPerSec << "/s";
+            if (e.bytesInFlight > 0)
+                os << ", " << e.bytesInFlight / (1 << 20) << " MB";
+            os << "\", color=\"" << heatColor(double(e.queueDepth) / std::max(redDepth, 1))
+               << "\", penwidth=" << 1 + std::log10(1 + e.packetsPerSec);
+            if (e.backEdge)
+                os << ", style=dashed";
+            os << "];\n";
+        }
+        os << "}\n";
+        return os.str();
+    }
+
+    //==============================================================================
+    std::string SnapshotToJson(const GraphSnapshot &snap) {
+        std::ostringstream os;
+        os << "{\"time_sec\": " << snap.timeSec << ", \"nodes\": [";
+        for (size_t i = 0; i < snap.nodes.size(); ++i) {
+            const NodeSnapshot &n = snap.nodes[i];
+            os << (i ? ", " : "") << "{\"name\": \"" << escape(n.name) << "\", \"calculator\": \""
+               << escape(n.calculator) << "\", \"process_calls\": " << n.processCalls
+               << ", \"busy_fraction\": " << n.busyFraction << "}";
+        }
+        os << "], \"edges\": [";
+        for (size_t i = 0; i < snap.edges.size(); ++i) {
+            const EdgeSnapshot &e = snap.edges[i];
+            os << (i ? ", " : "") << "{\"stream\": \"" << escape(e.stream) << "\", \"from\": \"" << escape(e.from)
+               << "\", \"to\": \"" << escape(e.to) << "\", \"back_edge\": " << (e.backEdge ? "true" : "false")
+               << ", \"produced\": " << e.produced << ", \"consumed\": " << e.consumed
+               << ", \"queue_depth\": " << e.queueDepth << ", \"packets_per_sec\": " << e.packetsPerSec
+               << ", \"bytes_in_flight\": " << e.bytesInFlight << "}";
+        }
+        os << "]}\n";
+        return os.str();
+    }
+}
+//==============================================================================
@@ -0,0 +1,118 @@
+#pragma once
+// Periodic snapshots of a running graph: queue depths, rates, busy nodes, exported as DOT and JSON
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// One node at the moment of the snapshot
+    struct NodeSnapshot {
+        std::string name, calculator;
+        int64 processCalls = 0;
+        double busyFraction = 0;   /// Time in Process() / wall time since the previous snapshot
+    };
+
+    /// One edge = one stream going to one consumer node
+    /// A stream read by 2 nodes gives 2 edges, they have separate queues
+    struct EdgeSnapshot {
+        std::string stream;
+        std::string from, to;      /// Node names, "INPUT" = graph input, "OUTPUT" = graph output
+        bool backEdge = false;
+        int64 produced = 0;        /// Packets sent to the stream so far
+        int64 consumed = 0;        /// Packets processed by the consumer so far
+        int64 queueDepth = 0;      /// produced - consumed: packets waiting in (or on the way to) the queue
+        double packetsPerSec = 0;  /// Production rate since the previous snapshot
+        double bytesInFlight = 0;  /// queueDepth * average packet size (known types only, e.g. ImageFrame)
+    };
+
+    struct GraphSnapshot {
+        double timeSec = 0;        /// Since GraphMonitor::Attach()
+        std::vector<NodeSnapshot> nodes;
+        std::vector<EdgeSnapshot> edges;
+    };
+
+    /// Graphviz DOT: nodes shaded by the busy fraction, edges coloured green -> yellow -> red
+    /// by queue depth (red at redDepth packets and more), and thicker for higher rates
+    std::string SnapshotToDot(const GraphSnapshot &snap, int redDepth = 10);
+
+    /// JSON for dashboards: {"time_sec": .., "nodes": [...], "edges": [...]}
+    std::string SnapshotToJson(const GraphSnapshot &snap);
+
+    //==============================================================================
+    /// Graph introspection with MP's own tools, no framework changes:
+    /// Packets produced on each stream (and their sizes) are counted by output stream observers,
+    /// packets consumed by each node on each input stream, and the time in Process(),
+    /// come from the graph profiler (calculator profiles with stream latency histograms)
+    /// Usage: Prepare(&config), graph.Initialize(config), Attach(&graph), graph.StartRun(),
+    /// then Snapshot() when you like, or StartPeriodic() from another thread, Stop() before the graph ends
+    /// Declare the monitor after the graph, so that its destructor stops the thread before the graph is destroyed
+    /// A disabled monitor does nothing at all: no profiler, no observers, zero overhead
+    class GraphMonitor {
+    public:
+        explicit GraphMonitor(bool enabled = true) : enabled(enabled) {}
+
+        ~GraphMonitor() { Stop(); }
+
+        /// Edit the config before Initialize(): enable the profiler, give unique names to unnamed nodes,
+        /// and remember the topology
+        void Prepare(CalculatorGraphConfig *config);
+
+        /// Attach observers to all streams, after Initialize() and before StartRun()
+        Status Attach(CalculatorGraph *graph);
+
+        /// Take a snapshot now, rates and busy fractions are since the previous snapshot
+        Status Snapshot(GraphSnapshot *snap);
+
+        /// Call callback with a snapshot every periodMs milliseconds, on a separate thread
+        void StartPeriodic(int periodMs, std::function<void(const GraphSnapshot &)> callback);
+
+        /// Stop the periodic snapshots
+        void Stop();
+
+        bool Enabled() const { return enabled; }
+
+    private:
+        /// Counters of one stream, updated by its observer
+        struct StreamCounters {
+            std::atomic<int64> produced{0};
+            std::atomic<int64> bytes{0};
+        };
+
+        struct Edge {
+            std::string stream, from, to;
+            bool backEdge;
+        };
+
+        bool enabled;
+        CalculatorGraph *graph = nullptr;
+        std::vector<NodeSnapshot> nodes;   /// Names and calculators
+        std::vector<Edge> edges;
+        std::map<std::string, std::string> producers;   /// Stream -> producer node
+        std::map<std::string, std::unique_ptr<StreamCounters>> counters;
+        int64 t0Us = 0;
+
+        /// The previous snapshot, for rates
+        std::mutex mutexSnapshot;
+        int64 prevUs = 0;
+        std::map<std::string, int64> prevProduced;
+        std::map<std::string, int64> prevBusyUs;
+
+        std::thread thread;
+        std::mutex mutexStop;
+        std::condition_variable condStop;
+        bool flagStop = false;
+    };
+}
+//==============================================================================
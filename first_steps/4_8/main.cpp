@@ -0,0 +1,170 @@
+/// Example 4.8 : Live graph topology snapshots
+/// By Oleksiy Grechnyev, IT-JIM
+/// When a graph like 3.1 lags, which edge is backing up ?
+/// GraphMonitor (graph_monitor.h) takes periodic snapshots of a running graph:
+/// queue depth, packets/sec and bytes in flight for each edge, and the busy fraction of each node
+/// It uses MP's own tools: output stream observers count the packets produced on each stream,
+/// and the graph profiler (enabled in the config by GraphMonitor::Prepare()) counts the packets consumed
+/// Every second we print the snapshot, and write it as 4_8_graph.dot (Graphviz, edges as a heatmap)
+/// and 4_8_graph.json (for dashboards), view with: dot -Tpng 4_8_graph.dot -o 4_8_graph.png
+/// The graph: camera -> copy -> SlowCalculator (200 ms, from 3.1) -> out
+///                           -> fast PassThrough -> preview
+/// Watch the queue frames -> slow grow, while frames -> fast stays empty
+/// With "off" the monitor is disabled and costs nothing
+/// Usage: 4_8 [on|off]
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/4_8/graph_monitor.h"
+
+//==============================================================================
+/// Print a snapshot as a table, and write it to files
+void printSnapshot(const mediapipe::GraphSnapshot &snap) {
+    using namespace std;
+    using namespace mediapipe;
+    cout << "===== SNAPSHOT t = " << fixed << setprecision(1) << snap.timeSec << " s" << endl;
+    for (const NodeSnapshot &n : snap.nodes)
+        cout << "NODE " << n.name << " (" << n.calculator << ") : calls = " << n.processCalls
+             << ", busy = " << int(100 * n.busyFraction + 0.5) << "%" << endl;
+    for (const EdgeSnapshot &e : snap.edges)
+        cout << "EDGE " << e.from << " -> " << e.to << " [" << e.stream << "] : queue = " << e.queueDepth
+             << ", " << e.packetsPerSec << " packets/s, " << e.bytesInFlight / (1 << 20) << " MB in flight"
+             << (e.backEdge ? " (back edge)" : "") << endl;
+    cout << defaultfloat;
+    ofstream("4_8_graph.dot") << SnapshotToDot(snap);
+    ofstream("4_8_graph.json") << SnapshotToJson(snap);
+}
+
+//==============================================================================
+mediapipe::Status run(bool monitorOn) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // The graph of 3.1 with a fast branch next to the slow one
+    string protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        output_stream: "preview"
+        node {
+            name: "copy"
+            calculator: "PassThroughCalculator"
+            input_stream: "in"
+            output_stream: "frames"
+        }
+        node {
+            name: "slow"
+            calculator: "SlowCalculator"
+            input_stream: "IMAGE:frames"
+            output_stream: "IMAGE:out"
+        }
+        node {
+            name: "fast"
+            calculator: "PassThroughCalculator"
+            input_stream: "frames"
+            output_stream: "preview"
+        }
+        )";
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    // The monitor is declared after the graph, so it is destroyed (and its thread stopped) first,
+    // even on the early error returns below
+    CalculatorGraph graph;
+    GraphMonitor monitor(monitorOn);
+    // The monitor edits the config (profiler, node names) before Initialize()
+    monitor.Prepare(&config);
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+    MP_RETURN_IF_ERROR(monitor.Attach(&graph));
+
+    // Mutex protecting imshow() and the stop flag
+    mutex mutexImshow;
+    atomic_bool flagStop(false);
+
+    // Display the slow output
+    auto cb = [&mutexImshow, &flagStop](const Packet &packet)->Status{
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        {
+            lock_guard<mutex> lock(mutexImshow);
+            // Display frame on screen and quit on ESC
+            cv::imshow("frameOut", frameOut);
+            if (27 == cv::waitKey(1)){
+                cout << "It's time to QUIT !" << endl;
+                flagStop = true;
+            }
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("preview", [](const Packet &packet)->Status{
+        return OkStatus();
+    }));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+    monitor.StartPeriodic(1000, printSnapshot);
+
+    // Start the camera and check that it works
+    cv::VideoCapture cap(cv::CAP_ANY);
+    if (!cap.isOpened())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    cv::Mat frameIn, frameInRGB;
+
+    // Camera loop, runs until we get flagStop == true
+    for (int i=0; !flagStop ; ++i){
+        // Read next frame from camera
+        cap.read(frameIn);
+        if (frameIn.empty())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+        {
+            lock_guard<mutex> lock(mutexImshow);
+            cv::imshow("frameIn", frameIn);
+        }
+
+        // Convert it to a packet and send
+        cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+        ImageFrame *inputFrame =  new ImageFrame(
+            ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary
+        );
+        frameInRGB.copyTo(formats::MatView(inputFrame));
+        Timestamp ts(i);
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", Adopt(inputFrame).At(ts)));
+    }
+    // Stop the snapshots before the graph finishes, close the input streams, Wait for the graph to finish
+    monitor.Stop();
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 4.8 : Live graph topology snapshots" << endl;
+    bool monitorOn = !(argc > 1 && string(argv[1]) == "off");
+    mediapipe::Status status = run(monitorOn);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <iostream>
+
+#include "mediapipe/examples/first_steps/4_9/async_calculator.h"
+
+//==============================================================================
+namespace mediapipe {
+    void AsyncWakeup::Notify() {
+        std::lock_guard<std::mutex> lock(mutexWake);
+        if (closed)
+            return;
+        // The graph fails on a timestamp which does not increase, hence the lock
+        graph->AddPacketToInputStream(streamName, MakePacket<int>(0).At(Timestamp(counter++))).IgnoreError();
+    }
+
+    //==============================================================================
+    void AsyncWakeup::Close() {
+        std::lock_guard<std::mutex> lock(mutexWake);
+        if (!closed)
+            graph->CloseInputStream(streamName).IgnoreError();
+        closed = true;
+    }
+
+    //==============================================================================
+    Status AsyncCalculatorBase::AsyncSetContract(CalculatorContract *cc) {
+        if (cc->Inputs().HasTag("WAKE") != cc->InputSidePackets().HasTag("WAKEUP"))
+            return absl::InvalidArgumentError("AsyncCalculatorBase : use WAKE and WAKEUP together");
+        if (cc->Inputs().HasTag("WAKE")) {
+            cc->Inputs().Tag("WAKE").SetAny();
+            cc->InputSidePackets().Tag("WAKEUP").Set<std::shared_ptr<AsyncWakeup>>();
+            cc->SetInputStreamHandler("ImmediateInputStreamHandler");
+        }
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status AsyncCalculatorBase::Open(CalculatorContext *cc) {
+        if (cc->Inputs().HasTag("WAKE")) {
+            wakeId = cc->Inputs().GetId("WAKE", 0);
+            wakeup = cc->InputSidePackets().Tag("WAKEUP").Get<std::shared_ptr<AsyncWakeup>>();
+        }
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status AsyncCalculatorBase::Process(CalculatorContext *cc) {
+        // With ImmediateInputStreamHandler we are called for WAKE alone: then only send the results
+        bool hasData = false;
+        for (CollectionItemId id = cc->Inputs().BeginId(); id < cc->Inputs().EndId(); ++id)
+            if (id != wakeId && !cc->Inputs().Get(id).IsEmpty())
+                hasData = true;
+
+        if (hasData) {
+            Timestamp ts = cc->InputTimestamp();
+            {
+                std::unique_lock<std::mutex> lock(mutexJobs);
+                // Backpressure: too many jobs, wait for the oldest one and send what we can
+                while (int(order.size()) >= std::max(maxInFlight, 1)) {
+                    if (!jobs[order.front()].completed) {
+                        numBlocked++;
+                        condJobs.wait(lock, [this] { return jobs[order.front()].completed; });
+                    }
+                    lock.unlock();
+                    MP_RETURN_IF_ERROR(sendReady(cc));
+                    lock.lock();
+                }
+                order.push_back(ts);
+                jobs[ts];
+                numJobs++;
+            }
+            // Only a copy of the shared_ptr is used after the job is marked completed:
+            // Close() may return and the calculator may be destroyed right then
+            std::shared_ptr<AsyncWakeup> wake = wakeup;
+            AsyncDone done = [this, ts, wake](const Status &status, const Packet &result) {
+                {
+                    std::lock_guard<std::mutex> lock(mutexJobs);
+                    Job &job = jobs[ts];
+                    job.completed = true;
+                    job.status = status;
+                    job.result = result;
+                    if (order.front() != ts)
+                        numReordered++;
+                    condJobs.notify_all();
+                }
+                if (wake)
+                    wake->Notify();
+            };
+            Status status = ProcessAsync(cc, done);
+            if (!status.ok())
+                return status;
+        }
+        return sendReady(cc);
+    }
+
+    //==============================================================================
+    Status AsyncCalculatorBase::Close(CalculatorContext *cc) {
+        {
+            std::unique_lock<std::mutex> lock(mutexJobs);
+            condJobs.wait(lock, [this] {
+                for (const auto &p : jobs)
+                    if (!p.second.completed)
+                        return false;
+                return true;
+            });
+        }
+        MP_RETURN_IF_ERROR(sendReady(cc));
+        std::cout << "AsyncCalculatorBase : " << numJobs << " jobs, " << numReordered
+                  << " completed out of order, " << numBlocked << " times blocked on max_in_flight" << std::endl;
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status AsyncCalculatorBase::sendReady(CalculatorContext *cc) {
+        OutputStream &out = cc->Outputs().Get(cc->Outputs().BeginId());
+        std::lock_guard<std::mutex> lock(mutexJobs);
+        while (!order.empty() && jobs[order.front()].completed) {
+            Timestamp ts = order.front();
+            Job job = std::move(jobs[ts]);
+            jobs.erase(ts);
+            order.pop_front();
+            if (!job.status.ok())
+                return job.status;
+            if (job.result.IsEmpty())
+                out.SetNextTimestampBound(ts.NextAllowedInStream());
+            else
+                out.AddPacket(job.result.At(ts));
+        }
+        return OkStatus();
+    }
+}
+//==============================================================================
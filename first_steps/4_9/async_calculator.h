@@ -0,0 +1,101 @@
+#pragma once
+// Base class for calculators which start external work in Process() and do not wait for it
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Wakes up async calculators when their work completes: each Notify() adds a packet to the graph
+    /// input stream streamName, which is connected to the input WAKE of the calculators
+    /// Pass it to them as the side packet WAKEUP (std::shared_ptr<AsyncWakeup>)
+    /// Thread-safe, Notify() can be called from any thread
+    class AsyncWakeup {
+    public:
+        AsyncWakeup(CalculatorGraph *graph, const std::string &streamName) :
+                graph(graph), streamName(streamName) {}
+
+        /// Add a wake-up packet, does nothing after Close()
+        void Notify();
+
+        /// Close the wake-up stream, call it instead of graph.CloseInputStream()
+        void Close();
+
+    private:
+        CalculatorGraph *graph;
+        std::string streamName;
+        std::mutex mutexWake;
+        int64 counter = 0;
+        bool closed = false;
+    };
+
+    /// The completion for AsyncCalculatorBase::ProcessAsync(), call it exactly once, from any thread
+    /// An empty result packet means "no output for this timestamp", an error status fails the graph
+    using AsyncDone = std::function<void(const Status &status, const Packet &result)>;
+
+    /// A calculator whose Process() only STARTS the work (I/O, accelerator, remote call) and returns,
+    /// so that the graph worker thread is free while the work is in progress
+    /// Derived classes implement ProcessAsync() instead of Process(), and call done() when the work completes;
+    /// the results are sent to the first output stream strictly in the order of input timestamps,
+    /// whatever the order of completions (a reorder buffer), each at the timestamp of its input
+    /// A MediaPipe calculator cannot output from a foreign thread: results are sent in the next Process() call
+    /// To get it right after the completion, connect the input WAKE and the side packet WAKEUP
+    /// (see AsyncWakeup) and call AsyncSetContract() in GetContract(): it sets ImmediateInputStreamHandler,
+    /// so with several data inputs they are NOT synchronized, use one data input stream
+    /// Without WAKE, results are sent on the next input packet and in Close()
+    /// At most maxInFlight jobs are started, then Process() waits for the oldest one (backpressure),
+    /// this and Close(), which waits for all jobs, are the only places where we block
+    /// Do not call cc->SetOffset(), outputs come later than their inputs
+    class AsyncCalculatorBase : public CalculatorBase {
+    public:
+        /// Call it from GetContract() of the derived class
+        static Status AsyncSetContract(CalculatorContract *cc);
+
+        Status Open(CalculatorContext *cc) override;
+
+        Status Process(CalculatorContext *cc) final;
+
+        /// Waits for all jobs and sends the remaining results, call it if you override Close()
+        Status Close(CalculatorContext *cc) override;
+
+    protected:
+        /// Start the work for the current input packets (timestamp cc->InputTimestamp()),
+        /// do not block, call done() when the work completes
+        /// The cc is valid only during this call, copy the packets you need
+        virtual Status ProcessAsync(CalculatorContext *cc, AsyncDone done) = 0;
+
+        /// Maximum number of jobs in progress, set it in Open()
+        int maxInFlight = 16;
+
+    private:
+        /// A job started by ProcessAsync()
+        struct Job {
+            bool completed = false;
+            Status status;
+            Packet result;
+        };
+
+        /// Send the completed results from the front of the queue
+        Status sendReady(CalculatorContext *cc);
+
+        std::shared_ptr<AsyncWakeup> wakeup;
+        CollectionItemId wakeId;
+
+        /// Protects everything below, done() runs on foreign threads
+        std::mutex mutexJobs;
+        std::condition_variable condJobs;
+        std::deque<Timestamp> order;     /// Timestamps of the jobs in progress, in input order
+        std::map<Timestamp, Job> jobs;
+        int64 numJobs = 0, numReordered = 0, numBlocked = 0;
+    };
+}
+//==============================================================================
@@ -0,0 +1,60 @@
+#include <random>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+
+#include "mediapipe/examples/first_steps/4_9/async_calculator.h"
+#include "mediapipe/examples/first_steps/4_9/async_slow_calculator.pb.h"
+#include "mediapipe/examples/first_steps/4_9/completion_timer.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// SlowCalculator (3.1) made async: the same photo-negative of the central 1/9,
+    /// but the 200 ms wait is external work (CompletionTimer) instead of this_thread::sleep_for(),
+    /// so no graph thread is blocked, and many frames are in progress at once
+    /// Optional input WAKE + side packet WAKEUP, see AsyncCalculatorBase
+    class AsyncSlowCalculator : public AsyncCalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            cc->Outputs().Tag("IMAGE").Set<ImageFrame>();
+            return AsyncSetContract(cc);
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<AsyncSlowCalculatorOptions>();
+            maxInFlight = options.max_in_flight();
+            return AsyncCalculatorBase::Open(cc);
+        }
+
+    protected:
+        Status ProcessAsync(CalculatorContext *cc, AsyncDone done) override {
+            // The work itself is quick, we do it right here
+            ImageFrame *iFrame = new ImageFrame();
+            iFrame->CopyFrom(cc->Inputs().Tag("IMAGE").Get<ImageFrame>(), 1);
+            cv::Mat img = formats::MatView(iFrame);
+            int nc = img.cols / 3, nr = img.rows / 3;
+            cv::Mat m(img, cv::Rect(nc, nr, nc, nr));
+            cv::bitwise_not(m, m);
+            Packet pOut = Adopt(iFrame);
+
+            // And then "wait" for the external device without blocking
+            double delayMs = options.delay_ms() + std::uniform_real_distribution<double>(0, options.jitter_ms())(rng);
+            timer.After(delayMs, [done, pOut] {
+                done(OkStatus(), pOut);
+            });
+            return OkStatus();
+        }
+
+    private:
+        AsyncSlowCalculatorOptions options;
+        std::mt19937 rng{2021};
+        CompletionTimer timer;
+    };
+    REGISTER_CALCULATOR(AsyncSlowCalculator);
+}
+//==============================================================================
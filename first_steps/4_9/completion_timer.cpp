@@ -0,0 +1,53 @@
+#include "mediapipe/examples/first_steps/4_9/completion_timer.h"
+
+//==============================================================================
+namespace mediapipe {
+    CompletionTimer::CompletionTimer() : threadTimer(&CompletionTimer::timerLoop, this) {
+    }
+
+    //==============================================================================
+    CompletionTimer::~CompletionTimer() {
+        {
+            std::lock_guard<std::mutex> lock(mutexTimer);
+            flagStop = true;
+        }
+        condTimer.notify_all();
+        threadTimer.join();
+    }
+
+    //==============================================================================
+    void CompletionTimer::After(double delayMs, std::function<void()> cb) {
+        auto due = std::chrono::steady_clock::now() + std::chrono::microseconds(int64_t(delayMs * 1000));
+        {
+            std::lock_guard<std::mutex> lock(mutexTimer);
+            queue.emplace(due, std::move(cb));
+        }
+        condTimer.notify_all();
+    }
+
+    //==============================================================================
+    void CompletionTimer::timerLoop() {
+        using namespace std;
+        unique_lock<mutex> lock(mutexTimer);
+        for (;;) {
+            if (queue.empty()) {
+                if (flagStop)
+                    return;
+                condTimer.wait(lock);
+                continue;
+            }
+            auto it = queue.begin();
+            if (!flagStop && it->first > chrono::steady_clock::now()) {
+                condTimer.wait_until(lock, it->first);
+                continue;
+            }
+            // Call the callback without the lock, it can submit new jobs
+            function<void()> cb = move(it->second);
+            queue.erase(it);
+            lock.unlock();
+            cb();
+            lock.lock();
+        }
+    }
+}
+//==============================================================================
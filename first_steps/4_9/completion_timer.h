@@ -0,0 +1,36 @@
+#pragma once
+// Runs callbacks after a delay on one thread, stands in for the completions of I/O or an accelerator
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+//==============================================================================
+namespace mediapipe {
+    /// Simulates an external device: a job submitted with After() "runs" for delayMs without any CPU,
+    /// then its callback is called on the timer thread, like a completion of async I/O or an accelerator
+    /// Jobs with different delays complete out of order
+    class CompletionTimer {
+    public:
+        CompletionTimer();
+
+        /// Calls the remaining callbacks right away, then joins the thread
+        ~CompletionTimer();
+
+        /// Call cb on the timer thread in delayMs milliseconds
+        void After(double delayMs, std::function<void()> cb);
+
+    private:
+        void timerLoop();
+
+        std::mutex mutexTimer;
+        std::condition_variable condTimer;
+        std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> queue;
+        bool flagStop = false;
+        std::thread threadTimer;
+    };
+}
+//==============================================================================
@@ -0,0 +1,151 @@
+/// Example 4.9 : Asynchronous Process()
+/// By Oleksiy Grechnyev, IT-JIM
+/// SlowCalculator (3.1) blocks a graph thread in this_thread::sleep_for(200ms), standing in for
+/// waits on I/O or an accelerator; it can process at most 5 frames per second, and the latency grows as in 3.1
+/// AsyncSlowCalculator starts the same external work (CompletionTimer) in Process() and returns at once,
+/// the results come back via a completion callback (AsyncCalculatorBase, async_calculator.h)
+/// Many frames are in progress at once and complete out of order (random 200-300 ms),
+/// a reorder buffer sends them in the order of timestamps, which we check in the observer
+/// "async" : completions wake the calculator via the WAKE stream (AsyncWakeup)
+/// "nowake" : no WAKE stream, results are sent only when the next frame arrives (a bit more latency)
+/// The graph has only ONE worker thread (num_threads: 1), it is enough in the async modes
+/// Usage: 4_9 [sync|async|nowake]
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/4_9/async_calculator.h"
+#include "mediapipe/examples/first_steps/5_4/capture_thread.h"
+
+//==============================================================================
+mediapipe::Status run(const std::string &mode) {
+    using namespace std;
+    using namespace mediapipe;
+
+    bool useWake = mode == "async";
+    string node;
+    if (mode == "sync") {
+        node = R"(
+        node {
+            calculator: "SlowCalculator"
+            input_stream: "IMAGE:in"
+            output_stream: "IMAGE:out"
+        }
+        )";
+    } else {
+        node = R"(
+        node {
+            calculator: "AsyncSlowCalculator"
+            input_stream: "IMAGE:in"
+            )" + string(useWake ? "input_stream: \"WAKE:wake\"\ninput_side_packet: \"WAKEUP:wakeup\"" : "") + R"(
+            output_stream: "IMAGE:out"
+            options: {
+                [mediapipe.AsyncSlowCalculatorOptions.ext] {
+                    delay_ms: 200
+                    jitter_ms: 100
+                }
+            }
+        }
+        )";
+    }
+    string protoG = R"(
+        input_stream: "in"
+        )" + string(useWake ? "input_stream: \"wake\"\ninput_side_packet: \"wakeup\"" : "") + R"(
+        output_stream: "out"
+        num_threads: 1
+        )" + node;
+
+    // Parse config and create graph
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    atomic_bool flagStop(false);
+    atomic_int count(0), countMisordered(0);
+    atomic<int64> lastTs(-1);
+    auto t1 = chrono::steady_clock::now();
+
+    // The observer checks the order, displays the frame with the latency and FPS
+    auto cb = [&](const Packet &packet)->Status{
+        int64 ts = packet.Timestamp().Value();
+        if (ts <= lastTs)
+            countMisordered++;
+        lastTs = ts;
+        count++;
+        double latencyMs = (CaptureThread::NowUs() - ts) / 1000.;
+        double fps = count / chrono::duration<double>(chrono::steady_clock::now() - t1).count();
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        string text = mode + " latency " + to_string(int(latencyMs)) + " ms, " + to_string(int(fps)) + " FPS";
+        cv::putText(frameOut, text, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 255, 0), 2);
+        cv::imshow("frameOut", frameOut);
+        if (27 == cv::waitKey(1)){
+            cout << "It's time to QUIT !" << endl;
+            flagStop = true;
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+
+    // The wake-up stream is fed by the completions, from the timer thread
+    shared_ptr<AsyncWakeup> wakeup;
+    map<string, Packet> sidePackets;
+    if (useWake) {
+        wakeup = make_shared<AsyncWakeup>(&graph, "wake");
+        sidePackets["wakeup"] = MakePacket<shared_ptr<AsyncWakeup>>(wakeup);
+    }
+    MP_RETURN_IF_ERROR(graph.StartRun(sidePackets));
+
+    // Start the capture, it runs until Stop()
+    CaptureThread capture;
+    MP_RETURN_IF_ERROR(capture.Start(&graph, "in"));
+    while (!flagStop && !capture.IsDone())
+        this_thread::sleep_for(chrono::milliseconds(100));
+    Status status = capture.Stop();
+
+    // Close the input streams, the jobs in progress complete in Close(), then Wait for the graph to finish
+    graph.CloseInputStream("in");
+    if (wakeup)
+        wakeup->Close();
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    cout << count << " frames, " << countMisordered << " out of order" << endl;
+    return status;
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 4.9 : Asynchronous Process()" << endl;
+    string mode = argc > 1 ? argv[1] : "async";
+    if (mode != "sync" && mode != "async" && mode != "nowake") {
+        cout << "Usage: 4_9 [sync|async|nowake]" << endl;
+        return 1;
+    }
+    mediapipe::Status status = run(mode);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
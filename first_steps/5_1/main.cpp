@@ -0,0 +1,152 @@
+/// Example 5.1 : Raw video recording and zero-copy replay
+/// By Oleksiy Grechnyev, IT-JIM
+/// Benchmarks with a live camera are not repeatable, and decoding a video file costs a lot
+/// Here we record camera frames into a raw container (raw_video_file.h): a header,
+/// uncompressed frames in page-aligned slots, and a timestamp index
+/// For replay, the file is memory-mapped, and RawVideoSourceCalculator sends ImageFrames
+/// pointing directly to the mapped pages: no decoding, no copying
+/// Usage:
+/// 5_1 record video.raw : record from the camera until ESC
+/// 5_1 play video.raw : replay at the recorded pace, with display
+/// 5_1 fast video.raw : replay as fast as possible, without display, and print the FPS
+/// Note: raw video is BIG (640x480 RGB at 30 fps is 27 MB/s), mind your disk space !
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/5_1/raw_video_file.h"
+
+//==============================================================================
+/// Record camera frames to the file path, no MP graph here
+mediapipe::Status record(const std::string &path) {
+    using namespace std;
+    using namespace mediapipe;
+    RawVideoWriter writer;
+    MP_RETURN_IF_ERROR(writer.Open(path));
+
+    cv::VideoCapture cap(cv::CAP_ANY);
+    if (!cap.isOpened())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    cv::Mat frameIn, frameInRGB;
+
+    // Timestamps are microseconds since the start of recording (monotonic clock),
+    // so that the replay can reproduce the real pace of the camera
+    auto tStart = chrono::steady_clock::now();
+    int i;
+    for (i=0; ; ++i){
+        cap.read(frameIn);
+        if (frameIn.empty())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+        int64 ts = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - tStart).count();
+
+        // We record the ImageFrame exactly as we would send it to the graph
+        cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+        ImageFrame inputFrame(ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary);
+        frameInRGB.copyTo(formats::MatView(&inputFrame));
+        MP_RETURN_IF_ERROR(writer.Write(inputFrame, ts));
+
+        cv::imshow("frameIn", frameIn);
+        if (27 == cv::waitKey(1))
+            break;
+    }
+    MP_RETURN_IF_ERROR(writer.Close());
+    cout << "Recorded " << i + 1 << " frames to " << path << endl;
+    return OkStatus();
+}
+
+//==============================================================================
+/// Replay the file through an MP graph
+mediapipe::Status play(const std::string &path, bool realtime) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // No graph input streams at all this time: the source calculator reads the file
+    // The path comes as a side packet: pasted into the text proto, quotes or backslashes would break it
+    string protoG = R"(
+        input_side_packet: "path"
+        output_stream: "out"
+        node {
+            calculator: "RawVideoSourceCalculator"
+            input_side_packet: "PATH:path"
+            output_stream: "IMAGE:out"
+            options: {
+                [mediapipe.RawVideoSourceCalculatorOptions.ext] {
+                    realtime: )" + (realtime ? "true" : "false") + R"(
+                }
+            }
+        }
+        )";
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    atomic_int count(0);
+    auto cb = [&count, realtime](const Packet &packet)->Status{
+        count++;
+        // Fast mode: no display, we only measure how fast the frames come
+        if (!realtime)
+            return OkStatus();
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        cout << packet.Timestamp() << ": RECEIVED VIDEO PACKET size = " << frameOut.size() << endl;
+        cv::imshow("frameOut", frameOut);
+        // ESC stops the graph this time
+        if (27 == cv::waitKey(1))
+            return absl::CancelledError("It's time to QUIT !");
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+
+    auto t1 = chrono::steady_clock::now();
+    MP_RETURN_IF_ERROR(graph.StartRun({{"path", MakePacket<string>(path)}}));
+    // The graph finishes when the source returns StatusStop
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    auto t2 = chrono::steady_clock::now();
+    double sec = chrono::duration<double>(t2 - t1).count();
+    cout << "Replayed " << count << " frames in " << sec << " s, " << count / sec << " FPS" << endl;
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 5.1 : Raw video recording and zero-copy replay" << endl;
+    if (argc != 3) {
+        cout << "Usage: 5_1 record|play|fast <file>" << endl;
+        return 1;
+    }
+    string mode(argv[1]), path(argv[2]);
+    mediapipe::Status status;
+    if (mode == "record")
+        status = record(path);
+    else if (mode == "play" || mode == "fast")
+        status = play(path, mode == "play");
+    else
+        status = absl::InvalidArgumentError("Unknown mode " + mode);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
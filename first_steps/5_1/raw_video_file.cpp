@@ -0,0 +1,239 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "mediapipe/examples/first_steps/5_1/raw_video_file.h"
+
+//==============================================================================
+namespace mediapipe {
+    namespace {
+        const char kMagic[8] = {'M', 'P', 'R', 'A', 'W', 'V', '0', '1'};
+
+        uint64 roundUpToPage(uint64 n) {
+            return (n + kRawVideoPage - 1) / kRawVideoPage * kRawVideoPage;
+        }
+
+        /// Formats ImageFrame supports (it CHECK-fails on the others), 0 if unknown
+        int pixelBytes(uint32 format) {
+            switch (format) {
+                case ImageFormat::GRAY8:
+                    return 1;
+                case ImageFormat::GRAY16:
+                    return 2;
+                case ImageFormat::SRGB:
+                case ImageFormat::LAB8:
+                    return 3;
+                case ImageFormat::SRGBA:
+                case ImageFormat::SBGRA:
+                case ImageFormat::VEC32F1:
+                    return 4;
+                case ImageFormat::SRGB48:
+                    return 6;
+                case ImageFormat::SRGBA64:
+                case ImageFormat::VEC32F2:
+                    return 8;
+                default:
+                    return 0;
+            }
+        }
+
+        /// All header fields agree with each other and with the file size, no arithmetic can overflow
+        bool headerIsValid(const RawVideoHeader &h, uint64 fileSize) {
+            int bpp = pixelBytes(h.format);
+            if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || bpp == 0 || h.width <= 0 || h.height <= 0 ||
+                h.widthStep < int64(h.width) * bpp)
+                return false;
+            uint64 frameBytes = uint64(h.widthStep) * uint64(h.height);
+            if (h.slotSize < frameBytes || h.dataOffset < sizeof(RawVideoHeader) || h.dataOffset > fileSize ||
+                h.indexOffset % sizeof(int64) != 0)
+                return false;
+            // Frames fit between dataOffset and indexOffset, the index fits in the file
+            if (h.numFrames > 0 && h.numFrames > (fileSize - h.dataOffset) / h.slotSize)
+                return false;
+            uint64 dataEnd = h.dataOffset + h.numFrames * h.slotSize;
+            return h.indexOffset >= dataEnd && h.indexOffset <= fileSize &&
+                   h.numFrames <= (fileSize - h.indexOffset) / sizeof(int64);
+        }
+    }
+
+    //==============================================================================
+    Status WritevAll(int fd, std::vector<iovec> *iov, uint64 *numCalls) {
+        std::vector<iovec> &v = *iov;
+        size_t first = 0;
+        // Skip empty pieces
+        while (first < v.size() && v[first].iov_len == 0)
+            first++;
+        while (first < v.size()) {
+            int cnt = int(std::min<size_t>(v.size() - first, IOV_MAX));
+            ssize_t n = writev(fd, &v[first], cnt);
+            (*numCalls)++;
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                return absl::InternalError(std::string("writev() failed : ") + std::strerror(errno));
+            }
+            // Skip what was written
+            while (n > 0 && first < v.size()) {
+                if (size_t(n) >= v[first].iov_len) {
+                    n -= v[first].iov_len;
+                    first++;
+                } else {
+                    v[first].iov_base = static_cast<char *>(v[first].iov_base) + n;
+                    v[first].iov_len -= n;
+                    n = 0;
+                }
+            }
+            while (first < v.size() && v[first].iov_len == 0)
+                first++;
+        }
+        return OkStatus();
+    }
+
+    //==============================================================================
+    RawVideoWriter::~RawVideoWriter() {
+        Close().IgnoreError();
+    }
+
+    //==============================================================================
+    Status RawVideoWriter::Open(const std::string &path) {
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return absl::NotFoundError("Cannot create file " + path);
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        timestamps.clear();
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status RawVideoWriter::checkFrame(const ImageFrame &frame) {
+        if (file == nullptr)
+            return absl::FailedPreconditionError("RawVideoWriter is not open !");
+        if (header.slotSize == 0) {
+            // The first frame defines the format, write the header and pad to the first slot
+            header.format = frame.Format();
+            header.width = frame.Width();
+            header.height = frame.Height();
+            header.widthStep = frame.WidthStep();
+            header.slotSize = roundUpToPage(uint64(frame.WidthStep()) * frame.Height());
+            header.dataOffset = kRawVideoPage;
+            padding.assign(kRawVideoPage, 0);
+            if (std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+                std::fwrite(padding.data(), kRawVideoPage - sizeof(header), 1, file) != 1)
+                return absl::InternalError("Cannot write raw video header !");
+        } else if (frame.Format() != header.format || frame.Width() != header.width ||
+                   frame.Height() != header.height || frame.WidthStep() != header.widthStep) {
+            return absl::InvalidArgumentError("RawVideoWriter : all frames must have the same size and format !");
+        }
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status RawVideoWriter::Write(const ImageFrame &frame, int64 ts) {
+        MP_RETURN_IF_ERROR(checkFrame(frame));
+        size_t size = size_t(frame.WidthStep()) * frame.Height();
+        if (std::fwrite(frame.PixelData(), size, 1, file) != 1 ||
+            (header.slotSize > size && std::fwrite(padding.data(), header.slotSize - size, 1, file) != 1))
+            return absl::InternalError("Cannot write raw video frame !");
+        timestamps.push_back(ts);
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status RawVideoWriter::WriteBatch(const std::vector<const ImageFrame *> &frames, const std::vector<int64> &ts,
+                                      uint64 *numCalls) {
+        if (frames.size() != ts.size())
+            return absl::InvalidArgumentError("RawVideoWriter::WriteBatch : frames and ts differ in size !");
+        if (frames.empty())
+            return OkStatus();
+        // The header goes through stdio, flush it before writing to the descriptor directly
+        for (const ImageFrame *frame : frames)
+            MP_RETURN_IF_ERROR(checkFrame(*frame));
+        if (std::fflush(file) != 0)
+            return absl::InternalError("Cannot write raw video header !");
+        std::vector<iovec> iov;
+        iov.reserve(2 * frames.size());
+        size_t size = size_t(header.widthStep) * header.height;
+        for (const ImageFrame *frame : frames) {
+            iov.push_back({const_cast<uint8 *>(frame->PixelData()), size});
+            iov.push_back({padding.data(), header.slotSize - size});
+        }
+        MP_RETURN_IF_ERROR(WritevAll(fileno(file), &iov, numCalls));
+        timestamps.insert(timestamps.end(), ts.begin(), ts.end());
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status RawVideoWriter::Close() {
+        if (file == nullptr)
+            return OkStatus();
+        header.numFrames = timestamps.size();
+        header.indexOffset = header.dataOffset + header.numFrames * header.slotSize;
+        bool ok = true;
+        if (!timestamps.empty())
+            ok = std::fwrite(timestamps.data(), sizeof(int64), timestamps.size(), file) == timestamps.size() &&
+                 std::fseek(file, 0, SEEK_SET) == 0 &&
+                 std::fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = (std::fclose(file) == 0) && ok;
+        file = nullptr;
+        return ok ? OkStatus() : absl::InternalError("Cannot finalize raw video file !");
+    }
+
+    //==============================================================================
+    RawVideoReader::Mapping::~Mapping() {
+        if (data != nullptr)
+            munmap(const_cast<uint8 *>(data), size);
+    }
+
+    //==============================================================================
+    Status RawVideoReader::Open(const std::string &path, bool prefault) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return absl::NotFoundError("Cannot open file " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(RawVideoHeader)) {
+            close(fd);
+            return absl::InvalidArgumentError("Bad raw video file " + path);
+        }
+        // Read-only and shared: the frames are the page cache itself, nothing is ever copied
+        // (a writable private mapping with MAP_POPULATE would copy the whole file to anonymous memory)
+        // MP packets are immutable anyway, a calculator must not write to the pixels
+        auto m = std::make_shared<Mapping>();
+        // MAP_POPULATE reads the whole file and maps all pages before the replay starts
+        int flags = MAP_SHARED | (prefault ? MAP_POPULATE : 0);
+        void *p = mmap(nullptr, st.st_size, PROT_READ, flags, fd, 0);
+        close(fd);  // The mapping stays valid
+        if (p == MAP_FAILED)
+            return absl::InternalError("Cannot mmap file " + path);
+        m->data = static_cast<const uint8 *>(p);
+        m->size = st.st_size;
+        // We read frames in order, let the kernel read ahead (this matters without prefault)
+        madvise(p, st.st_size, prefault ? MADV_WILLNEED : MADV_SEQUENTIAL);
+
+        std::memcpy(&header, m->data, sizeof(header));
+        if (!headerIsValid(header, m->size))
+            return absl::InvalidArgumentError("Bad raw video file " + path);
+        index = reinterpret_cast<const int64 *>(m->data + header.indexOffset);
+        mapping = m;
+        return OkStatus();
+    }
+
+    //==============================================================================
+    std::unique_ptr<ImageFrame> RawVideoReader::Frame(int64 i) const {
+        if (!mapping || i < 0 || uint64(i) >= header.numFrames)
+            return nullptr;
+        // ImageFrame wants a non-const pointer, the pages are read-only: do not modify the frame
+        uint8 *pixels = const_cast<uint8 *>(mapping->data + header.dataOffset + i * header.slotSize);
+        std::shared_ptr<Mapping> keep = mapping;
+        return std::unique_ptr<ImageFrame>(new ImageFrame(
+                static_cast<ImageFormat::Format>(header.format), header.width, header.height, header.widthStep,
+                pixels, [keep](uint8 *) {}));
+    }
+}
+//==============================================================================
@@ -0,0 +1,101 @@
+#pragma once
+// Raw video container: write frames to a file, map the file to memory for replay
+
+#include <sys/uio.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// File header, at offset 0
+    /// File layout: header, frames (each in a slot of slotSize bytes, aligned to pages), timestamp index
+    struct RawVideoHeader {
+        char magic[8];        /// "MPRAWV01"
+        uint32 format;        /// ImageFormat::Format
+        int32 width;
+        int32 height;
+        int32 widthStep;      /// Bytes per row, as in ImageFrame
+        uint64 slotSize;      /// Bytes per frame slot, a multiple of the page size
+        uint64 dataOffset;    /// Offset of frame 0
+        uint64 numFrames;
+        uint64 indexOffset;   /// Offset of the timestamp index: numFrames int64 timestamps
+    };
+
+    /// The page size we align to (also fine for 4K pages with huge mmap)
+    constexpr uint64 kRawVideoPage = 4096;
+
+    /// Write all pieces of iov to fd with as few writev() calls as possible (IOV_MAX pieces each,
+    /// resumed after partial writes), iov is consumed; the number of writev() calls is added to *numCalls
+    Status WritevAll(int fd, std::vector<iovec> *iov, uint64 *numCalls);
+
+    //==============================================================================
+    /// Records frames of the same size and format
+    class RawVideoWriter {
+    public:
+        ~RawVideoWriter();
+
+        /// Create the file, frame size and format are taken from the first frame
+        Status Open(const std::string &path);
+
+        /// Append a frame with timestamp ts
+        Status Write(const ImageFrame &frame, int64 ts);
+
+        /// Append several frames with one writev() (see WritevAll()), the number of writev() calls
+        /// is added to *numCalls
+        Status WriteBatch(const std::vector<const ImageFrame *> &frames, const std::vector<int64> &ts,
+                          uint64 *numCalls);
+
+        /// Write the timestamp index and the final header
+        Status Close();
+
+    private:
+        /// Write the header for the first frame, or check that the frame matches it
+        Status checkFrame(const ImageFrame &frame);
+
+        FILE *file = nullptr;
+        RawVideoHeader header;
+        std::vector<int64> timestamps;
+        std::vector<uint8> padding;
+    };
+
+    //==============================================================================
+    /// Maps a recorded file to memory and gives frames without copying pixels
+    class RawVideoReader {
+    public:
+        /// Map the file and check the header against the file size (a truncated or corrupt file is rejected)
+        /// prefault: read the whole file into memory now (MAP_POPULATE), so that Frame() never waits for the disk
+        /// and replay benchmarks measure the graph, not the page faults; false: pages are read on demand
+        Status Open(const std::string &path, bool prefault = true);
+
+        int64 NumFrames() const { return header.numFrames; }
+
+        int64 FrameTimestamp(int64 i) const { return index[i]; }
+
+        const RawVideoHeader &Header() const { return header; }
+
+        /// An ImageFrame pointing to the mapped pixels of frame i (zero-copy), nullptr if i is out of range
+        /// The mapping is read-only: writing to the pixels crashes, copy the frame to modify it
+        /// Its deleter does not free the pixels, it only keeps the mapping alive,
+        /// so the frame is valid even after the reader is destroyed
+        std::unique_ptr<ImageFrame> Frame(int64 i) const;
+
+    private:
+        /// The memory mapping, unmapped when the last frame using it is gone
+        struct Mapping {
+            const uint8 *data = nullptr;
+            size_t size = 0;
+            ~Mapping();
+        };
+        std::shared_ptr<Mapping> mapping;
+        RawVideoHeader header;
+        const int64 *index = nullptr;
+    };
+}
+//==============================================================================
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/5_1/raw_video_file.h"
+#include "mediapipe/examples/first_steps/5_1/raw_video_source_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// A source calculator which replays a raw video file, recorded with RawVideoWriter
+    /// Frames are NOT copied or decoded: each ImageFrame points to the memory-mapped file
+    /// Packets get the recorded timestamps
+    /// The file is the optional PATH input side packet (std::string), or else the path option
+    /// With realtime: true, frames are sent at the recorded pace, otherwise as fast as possible
+    /// With prefault: true (default), the file is read into memory in Open(), before the replay
+    class RawVideoSourceCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            if (cc->InputSidePackets().HasTag("PATH"))
+                cc->InputSidePackets().Tag("PATH").Set<std::string>();
+            cc->Outputs().Tag("IMAGE").Set<ImageFrame>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            using namespace std;
+            const auto &options = cc->Options<RawVideoSourceCalculatorOptions>();
+            realtime = options.realtime();
+            string path = cc->InputSidePackets().HasTag("PATH") ? cc->InputSidePackets().Tag("PATH").Get<string>()
+                                                                  : options.path();
+            MP_RETURN_IF_ERROR(reader.Open(path, options.prefault()));
+            const RawVideoHeader &h = reader.Header();
+            cout << "RawVideoSourceCalculator::Open() : " << path << ", " << reader.NumFrames()
+                 << " frames " << h.width << "x" << h.height << endl;
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            using namespace std;
+            if (i >= reader.NumFrames())
+                return tool::StatusStop();
+            int64 ts = reader.FrameTimestamp(i);
+            if (realtime) {
+                // Wait until the recorded time of this frame (relative to frame 0)
+                if (i == 0)
+                    tStart = chrono::steady_clock::now();
+                auto tFrame = tStart + chrono::microseconds(ts - reader.FrameTimestamp(0));
+                this_thread::sleep_until(tFrame);
+            }
+            std::unique_ptr<ImageFrame> frame = reader.Frame(i);
+            if (!frame)
+                return absl::InternalError("RawVideoSourceCalculator : cannot get frame " + to_string(i));
+            cc->Outputs().Tag("IMAGE").Add(frame.release(), Timestamp(ts));
+            i++;
+            return OkStatus();
+        }
+    private:
+        RawVideoReader reader;
+        bool realtime = true;
+        int64 i = 0;
+        std::chrono::steady_clock::time_point tStart;
+    };
+    REGISTER_CALCULATOR(RawVideoSourceCalculator);
+}
+//==============================================================================
@@ -0,0 +1,195 @@
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/opencv_imgcodecs_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/5_2/async_frame_writer.h"
+
+//==============================================================================
+namespace mediapipe {
+    AsyncFrameWriter::~AsyncFrameWriter() {
+        Close().IgnoreError();
+    }
+
+    //==============================================================================
+    Status AsyncFrameWriter::Open(const std::string &path, const std::string &format, int maxQueue, int maxBatch) {
+        if (isOpen)
+            return absl::FailedPreconditionError("AsyncFrameWriter is already open !");
+        // Checked before the file is created: an empty batch would spin the writer thread forever
+        if (maxQueue < 1 || maxBatch < 1)
+            return absl::InvalidArgumentError("AsyncFrameWriter : max_queue_frames and max_batch_frames must be >= 1");
+        if (format == "raw") {
+            MP_RETURN_IF_ERROR(rawWriter.Open(path));
+        } else if (format == "png" || format == "jpg") {
+            fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+                return absl::NotFoundError("Cannot create file " + path);
+        } else {
+            return absl::InvalidArgumentError("Unknown format " + format);
+        }
+        this->format = format;
+        this->maxQueue = maxQueue;
+        this->maxBatch = maxBatch;
+        flagStop = false;
+        isOpen = true;
+        writeStatus = OkStatus();
+        stats = AsyncFrameWriterStats();
+        tOpen = std::chrono::steady_clock::now();
+        thread = std::thread(&AsyncFrameWriter::writerLoop, this);
+        return OkStatus();
+    }
+
+    //==============================================================================
+    bool AsyncFrameWriter::Push(const Packet &packet) {
+        {
+            std::lock_guard<std::mutex> lock(mutexQueue);
+            stats.framesIn++;
+            if (!isOpen || flagStop || int(queue.size()) >= maxQueue) {
+                stats.framesDropped++;
+                return false;
+            }
+            // A packet copy is only a refcount increment, the pixels are shared
+            queue.push_back(packet);
+        }
+        condQueue.notify_one();
+        return true;
+    }
+
+    //==============================================================================
+    Status AsyncFrameWriter::Close() {
+        {
+            std::lock_guard<std::mutex> lock(mutexQueue);
+            if (!isOpen)
+                return OkStatus();
+            flagStop = true;
+        }
+        condQueue.notify_one();
+        thread.join();
+
+        Status status = writeStatus;
+        if (format == "raw") {
+            Status s = rawWriter.Close();
+            if (status.ok())
+                status = s;
+        } else if (fd >= 0) {
+            if (close(fd) != 0 && status.ok())
+                status = absl::InternalError("Cannot close file !");
+            fd = -1;
+        }
+        std::lock_guard<std::mutex> lock(mutexQueue);
+        isOpen = false;
+        return status;
+    }
+
+    //==============================================================================
+    AsyncFrameWriterStats AsyncFrameWriter::GetStats() const {
+        std::lock_guard<std::mutex> lock(mutexQueue);
+        AsyncFrameWriterStats s = stats;
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - tOpen).count();
+        if (sec > 0)
+            s.mbPerSec = s.bytesWritten / sec / 1e6;
+        return s;
+    }
+
+    //==============================================================================
+    void AsyncFrameWriter::writerLoop() {
+        using namespace std;
+        vector<Packet> batch;
+        for (;;) {
+            {
+                unique_lock<mutex> lock(mutexQueue);
+                condQueue.wait(lock, [this] { return flagStop || !queue.empty(); });
+                if (queue.empty())
+                    return;  // flagStop and nothing left to write
+                // Take everything (up to maxBatch) at once
+                batch.clear();
+                while (!queue.empty() && int(batch.size()) < maxBatch) {
+                    batch.push_back(move(queue.front()));
+                    queue.pop_front();
+                }
+            }
+            // The disk I/O happens here, with the mutex unlocked
+            Status status = writeStatus.ok() ? writeBatch(batch) : writeStatus;
+            lock_guard<mutex> lock(mutexQueue);
+            if (!status.ok()) {
+                // After an error we keep draining the queue, so that Push() stays non-blocking
+                writeStatus = status;
+                stats.framesDropped += batch.size();
+            }
+        }
+    }
+
+    //==============================================================================
+    Status AsyncFrameWriter::writeBatch(const std::vector<Packet> &batch) {
+        if (format == "raw") {
+            // The whole batch (pixels + slot padding of each frame) in one writev()
+            std::vector<const ImageFrame *> frames;
+            std::vector<int64> ts;
+            uint64 bytes = 0, numCalls = 0;
+            for (const Packet &p : batch) {
+                const ImageFrame &frame = p.Get<ImageFrame>();
+                frames.push_back(&frame);
+                ts.push_back(p.Timestamp().Value());
+                bytes += uint64(frame.WidthStep()) * frame.Height();
+            }
+            Status status = rawWriter.WriteBatch(frames, ts, &numCalls);
+            std::lock_guard<std::mutex> lock(mutexQueue);
+            stats.numWrites += numCalls;
+            if (!status.ok())
+                return status;
+            stats.framesWritten += batch.size();
+            stats.bytesWritten += bytes;
+            stats.numBatches++;
+            return OkStatus();
+        }
+        return writeEncoded(batch);
+    }
+
+    //==============================================================================
+    Status AsyncFrameWriter::writeEncoded(const std::vector<Packet> &batch) {
+        using namespace std;
+        // Record headers and encoded data for the whole batch
+        struct RecordHeader {
+            int64 ts;
+            uint32 size;
+        } __attribute__((packed));
+        vector<RecordHeader> headers(batch.size());
+        vector<vector<uchar>> buffers(batch.size());
+        vector<iovec> iov;
+        iov.reserve(2 * batch.size());
+        uint64 bytes = 0;
+        cv::Mat bgr;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const ImageFrame &frame = batch[i].Get<ImageFrame>();
+            cv::Mat mat = formats::MatView(&frame);
+            // OpenCV encoders expect BGR
+            if (mat.channels() == 3)
+                cv::cvtColor(mat, bgr, cv::COLOR_RGB2BGR);
+            else
+                bgr = mat;
+            if (!cv::imencode("." + format, bgr, buffers[i]))
+                return absl::InternalError("Cannot encode frame !");
+            headers[i].ts = batch[i].Timestamp().Value();
+            headers[i].size = buffers[i].size();
+            iov.push_back({&headers[i], sizeof(RecordHeader)});
+            iov.push_back({buffers[i].data(), buffers[i].size()});
+            bytes += sizeof(RecordHeader) + buffers[i].size();
+        }
+
+        // One writev() per batch (or per IOV_MAX pieces), resumed after partial writes
+        uint64 numCalls = 0;
+        Status status = WritevAll(fd, &iov, &numCalls);
+        lock_guard<mutex> lock(mutexQueue);
+        stats.numWrites += numCalls;
+        if (!status.ok())
+            return status;
+        stats.framesWritten += batch.size();
+        stats.bytesWritten += bytes;
+        stats.numBatches++;
+        return OkStatus();
+    }
+}
+//==============================================================================
@@ -0,0 +1,84 @@
+#pragma once
+// Writes frames to disk on a background thread
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/5_1/raw_video_file.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Statistics of AsyncFrameWriter
+    struct AsyncFrameWriterStats {
+        uint64 framesIn = 0;       /// Push() calls
+        uint64 framesWritten = 0;
+        uint64 framesDropped = 0;  /// Dropped because the queue was full
+        uint64 bytesWritten = 0;
+        uint64 numBatches = 0;     /// Batches written
+        uint64 numWrites = 0;      /// writev() calls, one per batch unless split by IOV_MAX or a partial write
+        double mbPerSec = 0;       /// Write throughput since Open()
+    };
+
+    /// Writes ImageFrame packets to a file on its own thread
+    /// Push() never waits for the disk: it only puts the packet (not a copy of the pixels!)
+    /// into a bounded queue, and drops it if the queue is full
+    /// The writer thread takes all queued packets at once and writes them as one batch
+    /// Formats:
+    /// raw : the raw video container of 5.1 (replay it with 5_1 play)
+    /// png, jpg : encoded frames, each record is {int64 timestamp, uint32 size, size bytes},
+    ///            the whole batch is written with a single writev() call
+    class AsyncFrameWriter {
+    public:
+        ~AsyncFrameWriter();
+
+        /// format is "raw", "png" or "jpg"
+        /// maxQueue = max frames waiting in the queue, maxBatch = max frames per batch, both must be >= 1
+        Status Open(const std::string &path, const std::string &format, int maxQueue, int maxBatch);
+
+        /// Queue a packet with an ImageFrame, returns false if it was dropped
+        bool Push(const Packet &packet);
+
+        /// Write everything still in the queue, stop the thread, close the file
+        /// Returns the first write error, if any
+        Status Close();
+
+        AsyncFrameWriterStats GetStats() const;
+
+    private:
+        void writerLoop();
+
+        /// Write one batch, called on the writer thread
+        Status writeBatch(const std::vector<Packet> &batch);
+
+        Status writeEncoded(const std::vector<Packet> &batch);
+
+        std::string format;
+        int maxQueue = 0;
+        int maxBatch = 0;
+        int fd = -1;
+        RawVideoWriter rawWriter;
+        std::thread thread;
+
+        /// Protects everything below
+        mutable std::mutex mutexQueue;
+        std::condition_variable condQueue;
+        std::deque<Packet> queue;
+        bool flagStop = false;
+        bool isOpen = false;
+        Status writeStatus;
+        AsyncFrameWriterStats stats;
+        std::chrono::steady_clock::time_point tOpen;
+    };
+}
+//==============================================================================
@@ -0,0 +1,59 @@
+#include <iostream>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/5_2/async_frame_writer.h"
+#include "mediapipe/examples/first_steps/5_2/image_sink_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// A sink: a calculator with no outputs, which writes all input frames to a file
+    /// The actual writing happens on the AsyncFrameWriter thread, Process() only queues the packet
+    /// If the disk is too slow, frames are dropped, but the graph is never blocked
+    class ImageSinkCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            const auto &options = cc->Options<ImageSinkCalculatorOptions>();
+            statsEvery = options.stats_every();
+            return writer.Open(options.path(), options.format(), options.max_queue_frames(),
+                               options.max_batch_frames());
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            // We pass the packet itself: no pixel copy on the graph thread
+            writer.Push(cc->Inputs().Tag("IMAGE").Value());
+            if (statsEvery > 0 && ++count % statsEvery == 0)
+                printStats();
+            return OkStatus();
+        }
+
+        Status Close(CalculatorContext *cc) override {
+            // Here we do wait for the disk: the remaining frames are written before the graph finishes
+            Status status = writer.Close();
+            printStats();
+            return status;
+        }
+
+    private:
+        void printStats() {
+            using namespace std;
+            AsyncFrameWriterStats s = writer.GetStats();
+            cout << "ImageSinkCalculator : in = " << s.framesIn << ", written = " << s.framesWritten
+                 << ", dropped = " << s.framesDropped << ", batches = " << s.numBatches
+                 << ", writes = " << s.numWrites << ", " << s.mbPerSec << " MB/s" << endl;
+        }
+
+        AsyncFrameWriter writer;
+        int statsEvery = 0;
+        int count = 0;
+    };
+    REGISTER_CALCULATOR(ImageSinkCalculator);
+}
+//==============================================================================
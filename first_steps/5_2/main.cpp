@@ -0,0 +1,153 @@
+/// Example 5.2 : Asynchronous disk sink
+/// By Oleksiy Grechnyev, IT-JIM
+/// So far the output video went only to cv::imshow()
+/// Here we also save it to a file with ImageSinkCalculator, a sink node (no outputs)
+/// Writing to disk can be slow and irregular, and it must never block the graph threads
+/// So the sink only queues packets for AsyncFrameWriter, which writes them in batches on its own thread
+/// The queue is bounded: if the disk cannot keep up, frames are dropped (and counted)
+/// Usage: 5_2 <file> [raw|png|jpg]
+/// raw files can be replayed with 5_1 play <file>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <cmath>
+#include <chrono>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+//==============================================================================
+mediapipe::Status run(const std::string &path, const std::string &format) {
+    using namespace std;
+    using namespace mediapipe;
+    
+    // Stream "in" goes both to the sink and to the display (via PassThroughCalculator)
+    // Try a tiny max_queue_frames with png, and watch the drops
+    string protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "ImageSinkCalculator"
+            input_stream: "IMAGE:in"
+            options: {
+                [mediapipe.ImageSinkCalculatorOptions.ext] {
+                    path: ")" + path + R"("
+                    format: ")" + format + R"("
+                    max_queue_frames: 30
+                    max_batch_frames: 8
+                }
+            }
+        }
+        node {
+            calculator: "PassThroughCalculator"
+            input_stream: "in"
+            output_stream: "out"
+        }
+        )";
+
+    // Parse config and create graph
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    } 
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+    
+    // Mutex protecting imshow() and the stop flag
+    mutex mutexImshow;
+    atomic_bool flagStop(false);
+
+    // Add observer to "out", then start the graph
+    // This callback displays the frame on the screen
+    auto cb = [&mutexImshow, &flagStop](const Packet &packet)->Status{
+
+        // Get cv::Mat from the packet
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        cout << packet.Timestamp() << ": RECEIVED VIDEO PACKET size = " << frameOut.size() << endl;
+
+        {
+            lock_guard<mutex> lock(mutexImshow);
+            // Display frame on screen and quit on ESC
+            cv::imshow("frameOut", frameOut);
+            if (27 == cv::waitKey(1)){
+                cout << "It's time to QUIT !" << endl;
+                flagStop = true;
+            }
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    graph.StartRun({});
+    
+    // Start the camera and check that it works
+    cv::VideoCapture cap(cv::CAP_ANY);
+    if (!cap.isOpened())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    cv::Mat frameIn, frameInRGB;
+
+    // Timestamps are microseconds since the start (monotonic clock), as in 5.1,
+    // so that 5_1 play replays a raw recording at the real pace of the camera
+    auto tStart = chrono::steady_clock::now();
+
+    // Camera loop, runs until we get flagStop == true
+    while (!flagStop){
+        // Read next frame from camera
+        cap.read(frameIn);
+        if (frameIn.empty())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+
+        cout << "SIZE_IN = " << frameIn.size() << endl;
+        {
+            lock_guard<mutex> lock(mutexImshow);
+            cv::imshow("frameIn", frameIn);
+        }
+
+        // Convert it to a packet and send
+        cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+        ImageFrame *inputFrame =  new ImageFrame(
+            ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary
+        );
+        frameInRGB.copyTo(formats::MatView(inputFrame));
+        Timestamp ts(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - tStart).count());
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", 
+            Adopt(inputFrame).At(ts)
+        ));
+
+    }
+    // Close the input streams, Wait for the graph to finish
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+    
+    cout << "Example 5.2 : Asynchronous disk sink" << endl;
+    if (argc < 2 || argc > 3) {
+        cout << "Usage: 5_2 <file> [raw|png|jpg]" << endl;
+        return 1;
+    }
+    string format = argc == 3 ? argv[2] : "raw";
+    mediapipe::Status status = run(argv[1], format);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,168 @@
+/// Example 5.3 : Parallel video decoding
+/// By Oleksiy Grechnyev, IT-JIM
+/// With a compressed video file instead of a camera, cap.read() decodes on the single ingest thread,
+/// and can be slower than the whole graph
+/// Here we use ParallelVideoDecoder (parallel_video_decoder.h), which decodes chunks of the video
+/// (ideally GOPs) on several threads ahead of time, and returns the frames in order
+/// We run the same graph with the usual serial loop and with the parallel decoder, and compare FPS
+/// Then we check that the decoder seeks exactly: the first frame of each chunk must be the same as in a serial decode
+/// Usage: 5_3 <video file> [threads=4] [chunk_frames=30] [prefetch_frames=120]
+/// Set chunk_frames to the GOP size (keyframe interval) of your video: seeking then starts at a keyframe
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <map>
+#include <atomic>
+#include <chrono>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/port/opencv_video_inc.h"
+
+#include "mediapipe/examples/first_steps/5_3/parallel_video_decoder.h"
+
+//==============================================================================
+/// Feed the whole video into a PassThrough graph, serial or parallel, and print FPS
+mediapipe::Status run(const std::string &path, bool parallel, int numThreads, int chunkFrames, int prefetchFrames) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // No display here, we only count the frames: all time goes to decoding
+    string protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "PassThroughCalculator"
+            input_stream: "in"
+            output_stream: "out"
+        }
+        )";
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+    atomic_int count(0);
+    auto cb = [&count](const Packet &packet)->Status{
+        count++;
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    auto t1 = chrono::steady_clock::now();
+    if (parallel) {
+        ParallelVideoDecoder decoder(path, numThreads, chunkFrames, prefetchFrames);
+        MP_RETURN_IF_ERROR(decoder.Start());
+        // Timestamps in microseconds from the frame index and FPS
+        unique_ptr<ImageFrame> frame;
+        int64 index;
+        while (decoder.Next(&frame, &index)) {
+            Timestamp ts(int64(index * 1e6 / decoder.Fps()));
+            MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", Adopt(frame.release()).At(ts)));
+        }
+    } else {
+        // The usual loop from the 2.x examples, with a file instead of a camera
+        cv::VideoCapture cap(path);
+        if (!cap.isOpened())
+            return absl::NotFoundError("Cannot open video " + path);
+        double fps = cap.get(cv::CAP_PROP_FPS);
+        if (fps <= 0)
+            fps = 30;
+        cv::Mat frameIn, frameInRGB;
+        for (int i=0; cap.read(frameIn) && !frameIn.empty(); ++i) {
+            cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+            ImageFrame *inputFrame =  new ImageFrame(
+                ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary
+            );
+            frameInRGB.copyTo(formats::MatView(inputFrame));
+            Timestamp ts(int64(i * 1e6 / fps));
+            MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", Adopt(inputFrame).At(ts)));
+        }
+    }
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    auto t2 = chrono::steady_clock::now();
+
+    double sec = chrono::duration<double>(t2 - t1).count();
+    cout << (parallel ? "PARALLEL (threads = " + to_string(numThreads) + ")" : string("SERIAL"))
+         << " : " << count << " frames in " << sec << " s, " << count / sec << " FPS" << endl;
+    return OkStatus();
+}
+
+//==============================================================================
+/// Compare the first frame of each chunk from ParallelVideoDecoder with a serial decode
+/// Some containers cannot seek frame-exactly, then the chunks start at a wrong frame
+mediapipe::Status verifySeeks(const std::string &path, int numThreads, int chunkFrames, int prefetchFrames) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // Serial decode, keep only the chunk starts (in BGR, as cap.read() gives them)
+    map<int64, cv::Mat> chunkStarts;
+    cv::VideoCapture cap(path);
+    if (!cap.isOpened())
+        return absl::NotFoundError("Cannot open video " + path);
+    cv::Mat frameIn;
+    for (int64 i = 0; cap.read(frameIn) && !frameIn.empty(); ++i) {
+        if (i % chunkFrames == 0)
+            chunkStarts[i] = frameIn.clone();
+    }
+
+    ParallelVideoDecoder decoder(path, numThreads, chunkFrames, prefetchFrames);
+    MP_RETURN_IF_ERROR(decoder.Start());
+    unique_ptr<ImageFrame> frame;
+    int64 index, numChecked = 0, numBad = 0;
+    cv::Mat frameBGR;
+    while (decoder.Next(&frame, &index)) {
+        auto it = chunkStarts.find(index);
+        if (it == chunkStarts.end())
+            continue;
+        cv::cvtColor(formats::MatView(frame.get()), frameBGR, cv::COLOR_RGB2BGR);
+        numChecked++;
+        if (frameBGR.size() != it->second.size() || cv::norm(frameBGR, it->second, cv::NORM_INF) != 0) {
+            if (numBad == 0)
+                cout << "VERIFY : chunk start " << index << " differs from the serial decode" << endl;
+            numBad++;
+        }
+    }
+    cout << "VERIFY : " << numChecked << " of " << chunkStarts.size() << " chunk starts checked, "
+         << numBad << " wrong" << endl;
+    if (numBad > 0)
+        cout << "VERIFY : seeking is not frame-exact in this file, set chunk_frames to its GOP size" << endl;
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 5.3 : Parallel video decoding" << endl;
+    if (argc < 2) {
+        cout << "Usage: 5_3 <video file> [threads=4] [chunk_frames=30] [prefetch_frames=120]" << endl;
+        return 1;
+    }
+    string path(argv[1]);
+    int numThreads = argc > 2 ? stoi(argv[2]) : 4;
+    int chunkFrames = argc > 3 ? stoi(argv[3]) : 30;
+    int prefetchFrames = argc > 4 ? stoi(argv[4]) : 120;
+
+    mediapipe::Status status = run(path, false, 1, chunkFrames, prefetchFrames);
+    if (status.ok())
+        status = run(path, true, numThreads, chunkFrames, prefetchFrames);
+    if (status.ok())
+        status = verifySeeks(path, numThreads, chunkFrames, prefetchFrames);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
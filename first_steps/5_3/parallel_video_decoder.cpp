@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <limits>
+
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/port/opencv_video_inc.h"
+
+#include "mediapipe/examples/first_steps/5_3/parallel_video_decoder.h"
+
+//==============================================================================
+namespace mediapipe {
+    ParallelVideoDecoder::ParallelVideoDecoder(const std::string &path, int numThreads, int chunkFrames,
+                                               int prefetchFrames) :
+            path(path), numThreads(std::max(numThreads, 1)), chunkFrames(std::max(chunkFrames, 1)),
+            prefetchFrames(std::max(prefetchFrames, 1)), endIndex(std::numeric_limits<int64>::max()) {
+    }
+
+    //==============================================================================
+    ParallelVideoDecoder::~ParallelVideoDecoder() {
+        {
+            std::lock_guard<std::mutex> lock(mutexState);
+            flagStop = true;
+        }
+        condWorkers.notify_all();
+        for (std::thread &t : threads)
+            t.join();
+    }
+
+    //==============================================================================
+    Status ParallelVideoDecoder::Start() {
+        // Check the file and get the FPS
+        cv::VideoCapture cap(path);
+        if (!cap.isOpened())
+            return absl::NotFoundError("Cannot open video " + path);
+        fps = cap.get(cv::CAP_PROP_FPS);
+        if (fps <= 0)
+            fps = 30;
+        for (int i = 0; i < numThreads; ++i)
+            threads.emplace_back(&ParallelVideoDecoder::workerLoop, this);
+        return OkStatus();
+    }
+
+    //==============================================================================
+    bool ParallelVideoDecoder::Next(std::unique_ptr<ImageFrame> *frame, int64 *index) {
+        std::unique_lock<std::mutex> lock(mutexState);
+        condConsumer.wait(lock, [this] {
+            return reorder.count(nextDeliver) > 0 || nextDeliver >= endIndex;
+        });
+        auto it = reorder.find(nextDeliver);
+        if (it == reorder.end())
+            return false;
+        *frame = std::move(it->second);
+        reorder.erase(it);
+        *index = nextDeliver++;
+        lock.unlock();
+        // There is space for one more frame now
+        condWorkers.notify_all();
+        return true;
+    }
+
+    //==============================================================================
+    void ParallelVideoDecoder::workerLoop() {
+        using namespace std;
+        cv::VideoCapture cap(path);
+        // The frame index which cap.read() returns next
+        int64 pos = 0;
+        cv::Mat frameIn, frameInRGB;
+        for (;;) {
+            int64 start;
+            {
+                unique_lock<mutex> lock(mutexState);
+                // Wait until the next chunk starts within the prefetch window
+                condWorkers.wait(lock, [this] {
+                    return flagStop || nextChunk * chunkFrames >= endIndex ||
+                           nextChunk * chunkFrames < nextDeliver + prefetchFrames;
+                });
+                if (flagStop || nextChunk * chunkFrames >= endIndex || !cap.isOpened()) {
+                    // Nothing more to decode. If we could not even open the file, end the video here
+                    if (!cap.isOpened())
+                        endIndex = min(endIndex, nextChunk * chunkFrames);
+                    condConsumer.notify_all();
+                    return;
+                }
+                start = nextChunk++ * chunkFrames;
+            }
+
+            // Seek only if we did not just decode the previous chunk ourselves
+            if (pos != start) {
+                cap.set(cv::CAP_PROP_POS_FRAMES, double(start));
+                pos = start;
+            }
+            for (int k = 0; k < chunkFrames; ++k) {
+                {
+                    // The prefetch window holds per frame, not only at the chunk start
+                    // No deadlock: the worker with frame nextDeliver always has pos == nextDeliver
+                    unique_lock<mutex> lock(mutexState);
+                    condWorkers.wait(lock, [this, pos] {
+                        return flagStop || pos < nextDeliver + prefetchFrames;
+                    });
+                    if (flagStop)
+                        return;
+                }
+                if (!cap.read(frameIn) || frameIn.empty()) {
+                    // The end of the video
+                    lock_guard<mutex> lock(mutexState);
+                    endIndex = min(endIndex, pos);
+                    condConsumer.notify_all();
+                    condWorkers.notify_all();
+                    break;
+                }
+                // Colour conversion and ImageFrame creation run in parallel too
+                cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+                unique_ptr<ImageFrame> frame(new ImageFrame(
+                        ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary));
+                frameInRGB.copyTo(formats::MatView(frame.get()));
+                {
+                    lock_guard<mutex> lock(mutexState);
+                    reorder[pos] = move(frame);
+                }
+                condConsumer.notify_one();
+                pos++;
+            }
+        }
+    }
+}
+//==============================================================================
@@ -0,0 +1,63 @@
+#pragma once
+// Decodes a video file on several threads, delivers frames in order
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// A parallel, read-ahead replacement for the cv::VideoCapture::read() loop
+    /// The video is cut into chunks of chunkFrames frames (ideally one GOP: a keyframe and what follows)
+    /// Each thread has its own cv::VideoCapture, takes the next free chunk, seeks to it and decodes it
+    /// Decoded frames (already converted to RGB ImageFrame) go to a reorder buffer,
+    /// and Next() returns them strictly in order
+    /// Threads decode at most prefetchFrames frames ahead of the consumer (checked before each frame),
+    /// and the destructor stops them after the frame they are decoding, not after the whole chunk
+    /// Seeks use CAP_PROP_POS_FRAMES, which is frame-exact only if the backend can seek exactly in this file
+    /// (FFmpeg decodes from the previous keyframe); main.cpp checks the first frame of each chunk against
+    /// a serial decode and warns if the seeks are not exact
+    class ParallelVideoDecoder {
+    public:
+        ParallelVideoDecoder(const std::string &path, int numThreads, int chunkFrames, int prefetchFrames);
+
+        /// Stops and joins all threads
+        ~ParallelVideoDecoder();
+
+        /// Open the file and start the threads
+        Status Start();
+
+        /// Get the next frame in order, waits if needed, returns false at the end of the video
+        bool Next(std::unique_ptr<ImageFrame> *frame, int64 *index);
+
+        /// Frames per second of the video
+        double Fps() const { return fps; }
+
+    private:
+        void workerLoop();
+
+        std::string path;
+        int numThreads, chunkFrames, prefetchFrames;
+        double fps = 0;
+        std::vector<std::thread> threads;
+
+        /// Protects everything below
+        std::mutex mutexState;
+        std::condition_variable condWorkers;   /// Workers wait for space in the reorder buffer
+        std::condition_variable condConsumer;  /// Next() waits for the next frame
+        int64 nextChunk = 0;     /// Next chunk to decode
+        int64 nextDeliver = 0;   /// Next frame index for Next()
+        int64 endIndex;          /// Index of the first frame which does not exist (known at the end)
+        bool flagStop = false;
+        std::map<int64, std::unique_ptr<ImageFrame>> reorder;
+    };
+}
+//==============================================================================
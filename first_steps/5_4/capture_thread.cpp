@@ -0,0 +1,145 @@
+#include <algorithm>
+
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/5_4/capture_thread.h"
+
+//==============================================================================
+namespace mediapipe {
+    CaptureThread::~CaptureThread() {
+        Stop().IgnoreError();
+    }
+
+    //==============================================================================
+    Status CaptureThread::Start(CalculatorGraph *graph, const std::string &streamName, int device) {
+        if (threadCapture.joinable())
+            return absl::FailedPreconditionError("CaptureThread is already started !");
+        // Open the camera here, so that the error is reported right away
+        if (!cap.open(device))
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+        this->graph = graph;
+        this->streamName = streamName;
+        flagStop = false;
+        {
+            std::lock_guard<std::mutex> lock(mutexSlot);
+            slotFresh = false;
+            captureDone = false;
+            status = OkStatus();
+            stats = CaptureThreadStats();
+            latencySumUs = 0;
+        }
+        threadCapture = std::thread(&CaptureThread::captureLoop, this);
+        threadEnqueue = std::thread(&CaptureThread::enqueueLoop, this);
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status CaptureThread::Stop() {
+        if (!threadCapture.joinable())
+            return OkStatus();
+        flagStop = true;
+        condSlot.notify_all();
+        threadCapture.join();
+        threadEnqueue.join();
+        cap.release();
+        std::lock_guard<std::mutex> lock(mutexSlot);
+        return status;
+    }
+
+    //==============================================================================
+    CaptureThreadStats CaptureThread::GetStats() const {
+        std::lock_guard<std::mutex> lock(mutexSlot);
+        CaptureThreadStats s = stats;
+        if (s.framesEnqueued > 0)
+            s.latencyAvgUs = latencySumUs / s.framesEnqueued;
+        return s;
+    }
+
+    //==============================================================================
+    bool CaptureThread::IsDone() const {
+        std::lock_guard<std::mutex> lock(mutexSlot);
+        return captureDone;
+    }
+
+    //==============================================================================
+    void CaptureThread::captureLoop() {
+        using namespace std;
+        // The buffer filled by the camera
+        cv::Mat back;
+        int64 lastTs = 0;
+        while (!flagStop) {
+            // grab() returns when the frame has arrived, this is our capture time
+            // retrieve() (decoding) is not included
+            if (!cap.grab()) {
+                lock_guard<mutex> lock(mutexSlot);
+                status = absl::NotFoundError("CANNOT READ FROM CAMERA !");
+                break;
+            }
+            int64 ts = NowUs();
+            if (!cap.retrieve(back) || back.empty()) {
+                lock_guard<mutex> lock(mutexSlot);
+                status = absl::NotFoundError("CANNOT READ FROM CAMERA !");
+                break;
+            }
+            // MP needs strictly increasing timestamps
+            ts = max(ts, lastTs + 1);
+            lastTs = ts;
+            {
+                lock_guard<mutex> lock(mutexSlot);
+                stats.framesCaptured++;
+                if (slotFresh)
+                    stats.framesDropped++;
+                // The old slot buffer becomes our next back buffer, no allocation if the size is the same
+                swap(slot, back);
+                slotTs = ts;
+                slotFresh = true;
+            }
+            condSlot.notify_one();
+        }
+        {
+            lock_guard<mutex> lock(mutexSlot);
+            captureDone = true;
+        }
+        condSlot.notify_one();
+    }
+
+    //==============================================================================
+    void CaptureThread::enqueueLoop() {
+        using namespace std;
+        // The buffer being converted and sent
+        cv::Mat front;
+        for (;;) {
+            int64 ts;
+            {
+                unique_lock<mutex> lock(mutexSlot);
+                condSlot.wait(lock, [this] { return slotFresh || captureDone || flagStop; });
+                if (!slotFresh)
+                    return;
+                swap(slot, front);
+                ts = slotTs;
+                slotFresh = false;
+            }
+
+            // The conversion runs here, while the capture thread waits for the next frame
+            ImageFrame *inputFrame = new ImageFrame(
+                    ImageFormat::SRGB, front.cols, front.rows, ImageFrame::kDefaultAlignmentBoundary);
+            cv::cvtColor(front, formats::MatView(inputFrame), cv::COLOR_BGR2RGB);
+            Status s = graph->AddPacketToInputStream(streamName, Adopt(inputFrame).At(Timestamp(ts)));
+            double latency = NowUs() - ts;
+
+            lock_guard<mutex> lock(mutexSlot);
+            if (!s.ok()) {
+                if (status.ok())
+                    status = s;
+                flagStop = true;
+                return;
+            }
+            stats.framesEnqueued++;
+            latencySumUs += latency;
+            stats.latencyMaxUs = max(stats.latencyMaxUs, latency);
+        }
+    }
+}
+//==============================================================================
@@ -0,0 +1,86 @@
+#pragma once
+// Camera capture on a dedicated thread, with monotonic-clock timestamps
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/opencv_video_inc.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Statistics of CaptureThread
+    struct CaptureThreadStats {
+        uint64 framesCaptured = 0;
+        uint64 framesEnqueued = 0;
+        uint64 framesDropped = 0;   /// Captured, but replaced by a newer frame before we could enqueue it
+        double latencyAvgUs = 0;    /// Capture -> AddPacketToInputStream() returned, microseconds
+        double latencyMaxUs = 0;
+    };
+
+    /// A reusable ingest stage which replaces the usual camera loop of the 2.x, 3.x examples
+    /// Two threads:
+    /// Capture thread: only grabs frames from the camera, nothing else, so it never misses one
+    /// Enqueue thread: converts BGR -> RGB ImageFrame and calls AddPacketToInputStream()
+    /// They are decoupled by double buffering: the camera fills one cv::Mat while the other is being
+    /// converted (plus a hand-off slot, all three are swapped, never copied)
+    /// If the enqueue thread is late, the frame in the hand-off slot is replaced by a newer one
+    /// and counted as dropped: we always send the freshest frame
+    /// Packet timestamp = capture time in microseconds of the monotonic clock (see NowUs()),
+    /// not the frame index, so that Timestamp differences are real time differences,
+    /// and the end-to-end latency at any point of the graph is NowUs() - packet.Timestamp().Value()
+    class CaptureThread {
+    public:
+        ~CaptureThread();
+
+        /// Open the camera and start both threads, the packets go to the graph input stream streamName
+        /// The graph must be already started with StartRun()
+        Status Start(CalculatorGraph *graph, const std::string &streamName, int device = cv::CAP_ANY);
+
+        /// Stop and join the threads, close the camera (the graph input stream is NOT closed)
+        /// Returns the first error of the camera or the graph, if any
+        Status Stop();
+
+        CaptureThreadStats GetStats() const;
+
+        /// True if the threads have stopped by themselves (camera or graph error), call Stop() to get the error
+        bool IsDone() const;
+
+        /// Current time of the monotonic clock in microseconds, the same clock as packet timestamps
+        static int64 NowUs() {
+            using namespace std::chrono;
+            return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        void captureLoop();
+
+        void enqueueLoop();
+
+        CalculatorGraph *graph = nullptr;
+        std::string streamName;
+        cv::VideoCapture cap;
+        std::thread threadCapture, threadEnqueue;
+        std::atomic_bool flagStop{false};
+
+        /// Protects everything below
+        mutable std::mutex mutexSlot;
+        std::condition_variable condSlot;
+        cv::Mat slot;              /// The hand-off slot between the threads
+        int64 slotTs = 0;          /// Capture time of the frame in the slot
+        bool slotFresh = false;    /// True if the slot holds a frame not yet taken by the enqueue thread
+        bool captureDone = false;  /// The capture thread has exited
+        Status status;
+        CaptureThreadStats stats;
+        double latencySumUs = 0;
+    };
+}
+//==============================================================================
@@ -0,0 +1,121 @@
+/// Example 5.4 : Dedicated capture thread
+/// By Oleksiy Grechnyev, IT-JIM
+/// In all previous camera examples, one loop did everything: cap.read(), imshow(), cvtColor(),
+/// AddPacketToInputStream(), and the timestamp was the frame index Timestamp(i)
+/// Here the camera is handled by CaptureThread (capture_thread.h), which captures on its own thread,
+/// converts and sends the frames on another thread, and stamps each packet with the capture time
+/// in microseconds of the monotonic clock
+/// Now packet timestamps mean something: in the observer we print the real end-to-end latency
+/// (capture -> out), and the capture thread reports the capture -> enqueue latency and dropped frames
+/// The graph is the one of example 3.2 (FlowLimiterCalculator + SlowCalculator)
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <thread>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/5_4/capture_thread.h"
+
+//==============================================================================
+mediapipe::Status run() {
+    using namespace std;
+    using namespace mediapipe;
+
+    // The graph of example 3.2
+    string protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "FlowLimiterCalculator"
+            input_stream: "in"
+            input_stream: "FINISHED:out"
+            input_stream_info: {
+                tag_index: "FINISHED"
+                back_edge: true
+            }
+            output_stream: "out1"
+        }
+        node {
+            calculator: "SlowCalculator"
+            input_stream: "IMAGE:out1"
+            output_stream: "IMAGE:out"
+        }
+        )";
+
+    // Parse config and create graph
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    atomic_bool flagStop(false);
+
+    // The observer displays the frame and prints the end-to-end latency
+    // Only the observer calls imshow() now, so no mutex is needed
+    auto cb = [&flagStop](const Packet &packet)->Status{
+        // Timestamp is the capture time on the same clock as CaptureThread::NowUs()
+        int64 latency = CaptureThread::NowUs() - packet.Timestamp().Value();
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        cout << packet.Timestamp() << ": RECEIVED VIDEO PACKET, latency = " << latency / 1000. << " ms" << endl;
+        cv::imshow("frameOut", frameOut);
+        if (27 == cv::waitKey(1)){
+            cout << "It's time to QUIT !" << endl;
+            flagStop = true;
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // Start the capture, it runs until Stop()
+    CaptureThread capture;
+    MP_RETURN_IF_ERROR(capture.Start(&graph, "in"));
+
+    // The main thread has nothing to do but print the statistics once a second
+    // IsDone() becomes true if the camera or the graph fails
+    while (!flagStop && !capture.IsDone()) {
+        this_thread::sleep_for(chrono::seconds(1));
+        CaptureThreadStats s = capture.GetStats();
+        cout << "CAPTURE : captured = " << s.framesCaptured << ", enqueued = " << s.framesEnqueued
+             << ", dropped = " << s.framesDropped << ", latency avg = " << s.latencyAvgUs
+             << " us, max = " << s.latencyMaxUs << " us" << endl;
+    }
+    Status status = capture.Stop();
+
+    // Close the input streams, Wait for the graph to finish
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return status;
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 5.4 : Dedicated capture thread" << endl;
+    mediapipe::Status status = run();
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
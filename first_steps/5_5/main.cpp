@@ -0,0 +1,182 @@
+/// Example 5.5 : Packet trace recording and replay
+/// By Oleksiy Grechnyev, IT-JIM
+/// To reproduce a performance problem, we need the same input: the same packets with the same timing
+/// PacketTraceRecorder (packet_trace.h) writes every graph input packet (stream name, timestamp,
+/// arrival time, serialized payload) to a compact append-only file
+/// PacketTraceReplayer feeds the file back with the original timing, or as fast as possible
+/// Packet types are handled by codecs: double (as in 1.2, 1.4), std::string (1.3), Rect (2.3) and a few more
+/// Other types can be added with RegisterPacketCodec()
+/// Here the graph has three inputs of these types: in_x (double), in_str (string), in_rect (Rect)
+/// "record" generates irregular traffic for a few seconds and records it, "replay" replays it
+/// Both print the output counts and checksums, which must be the same
+/// Usage: 5_5 record <trace file> [seconds=5]
+///        5_5 replay <trace file> [realtime|fast]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <cmath>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/5_5/packet_trace.h"
+
+//==============================================================================
+/// Counts and checksums of the output packets
+struct OutputSummary {
+    std::mutex mutexSummary;
+    std::map<std::string, int> counts;
+    std::map<std::string, double> checksums;
+
+    void add(const std::string &stream, double value) {
+        std::lock_guard<std::mutex> lock(mutexSummary);
+        counts[stream]++;
+        checksums[stream] += value;
+    }
+
+    void print() {
+        for (const auto &p : counts)
+            std::cout << p.first << " : " << p.second << " packets, checksum = " << checksums[p.first] << std::endl;
+    }
+};
+
+//==============================================================================
+/// Generate irregular traffic on the three inputs, record it
+mediapipe::Status record(mediapipe::CalculatorGraph &graph, const std::string &path, double seconds) {
+    using namespace std;
+    using namespace mediapipe;
+    PacketTraceRecorder recorder;
+    MP_RETURN_IF_ERROR(recorder.Open(path));
+    mt19937 rng(2021);
+    uniform_int_distribution<int> sleepUs(200, 3000);
+    auto t0 = chrono::steady_clock::now();
+    for (int i = 0; chrono::steady_clock::now() - t0 < chrono::duration<double>(seconds); ++i) {
+        Timestamp ts(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - t0).count());
+        MP_RETURN_IF_ERROR(recorder.AddPacketToInputStream(&graph, "in_x", MakePacket<double>(sin(0.1 * i)).At(ts)));
+        if (i % 3 == 0)
+            MP_RETURN_IF_ERROR(recorder.AddPacketToInputStream(
+                    &graph, "in_str", MakePacket<string>("Message #" + to_string(i)).At(ts)));
+        if (i % 5 == 0) {
+            Rect rect;
+            rect.set_x_center(320 + int(100 * cos(0.3 * i)));
+            rect.set_y_center(240);
+            rect.set_width(200);
+            rect.set_height(100);
+            MP_RETURN_IF_ERROR(recorder.AddPacketToInputStream(&graph, "in_rect", MakePacket<Rect>(rect).At(ts)));
+        }
+        // Bursts and pauses, as in real traffic
+        this_thread::sleep_for(chrono::microseconds(sleepUs(rng)));
+    }
+    cout << "Recorded " << recorder.NumPackets() << " packets to " << path << endl;
+    return recorder.Close();
+}
+
+//==============================================================================
+mediapipe::Status run(bool isRecord, const std::string &path, double seconds, bool realTime) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // Three independent PassThrough nodes, in place of your real graph
+    string protoG = R"(
+        input_stream: "in_x"
+        input_stream: "in_str"
+        input_stream: "in_rect"
+        output_stream: "out_x"
+        output_stream: "out_str"
+        output_stream: "out_rect"
+        node {
+            calculator: "PassThroughCalculator"
+            input_stream: "in_x"
+            output_stream: "out_x"
+        }
+        node {
+            calculator: "PassThroughCalculator"
+            input_stream: "in_str"
+            output_stream: "out_str"
+        }
+        node {
+            calculator: "PassThroughCalculator"
+            input_stream: "in_rect"
+            output_stream: "out_rect"
+        }
+        )";
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    // Checksums include timestamps, so the replay must reproduce them too
+    OutputSummary summary;
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out_x", [&summary](const Packet &packet) -> Status {
+        summary.add("out_x", packet.Get<double>() + 1e-6 * packet.Timestamp().Value());
+        return OkStatus();
+    }));
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out_str", [&summary](const Packet &packet) -> Status {
+        summary.add("out_str", packet.Get<string>().size() + 1e-6 * packet.Timestamp().Value());
+        return OkStatus();
+    }));
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out_rect", [&summary](const Packet &packet) -> Status {
+        summary.add("out_rect", packet.Get<Rect>().x_center() + 1e-6 * packet.Timestamp().Value());
+        return OkStatus();
+    }));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    auto t1 = chrono::steady_clock::now();
+    if (isRecord) {
+        MP_RETURN_IF_ERROR(record(graph, path, seconds));
+    } else {
+        PacketTraceReplayer replayer;
+        MP_RETURN_IF_ERROR(replayer.Open(path));
+        cout << "Loaded " << replayer.NumPackets() << " packets, streams :";
+        for (const string &s : replayer.StreamNames())
+            cout << " " << s;
+        cout << endl;
+        MP_RETURN_IF_ERROR(replayer.Run(&graph, realTime));
+        if (realTime)
+            cout << "Max lag behind the original timing = " << replayer.MaxLagUs() << " us" << endl;
+    }
+    graph.CloseInputStream("in_x");
+    graph.CloseInputStream("in_str");
+    graph.CloseInputStream("in_rect");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    auto t2 = chrono::steady_clock::now();
+
+    cout << "Time = " << chrono::duration<double>(t2 - t1).count() << " s" << endl;
+    summary.print();
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 5.5 : Packet trace recording and replay" << endl;
+    string mode = argc > 1 ? argv[1] : "";
+    if (argc < 3 || (mode != "record" && mode != "replay")) {
+        cout << "Usage: 5_5 record <trace file> [seconds=5]" << endl;
+        cout << "       5_5 replay <trace file> [realtime|fast]" << endl;
+        return 1;
+    }
+    string path(argv[2]);
+    double seconds = (mode == "record" && argc > 3) ? stod(argv[3]) : 5;
+    bool realTime = !(mode == "replay" && argc > 3 && string(argv[3]) == "fast");
+
+    mediapipe::Status status = run(mode == "record", path, seconds, realTime);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
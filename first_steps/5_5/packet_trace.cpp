@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "mediapipe/framework/formats/rect.pb.h"
+
+#include "mediapipe/examples/first_steps/5_5/packet_trace.h"
+
+//==============================================================================
+namespace mediapipe {
+    namespace {
+        const char kMagic[8] = {'M', 'P', 'T', 'R', 'A', 'C', 'E', '1'};
+        constexpr uint8 kRecordStream = 1;
+        constexpr uint8 kRecordPacket = 2;
+
+        int64 nowUs() {
+            using namespace std::chrono;
+            return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        //==============================================================================
+        // LEB128 varints, zigzag for signed numbers, so that small deltas take 1-2 bytes
+        void putVarint(std::string *s, uint64 v) {
+            while (v >= 0x80) {
+                s->push_back(char(v | 0x80));
+                v >>= 7;
+            }
+            s->push_back(char(v));
+        }
+
+        void putString(std::string *s, const std::string &str) {
+            putVarint(s, str.size());
+            s->append(str);
+        }
+
+        uint64 zigzag(int64 v) {
+            return (uint64(v) << 1) ^ uint64(v >> 63);
+        }
+
+        int64 unzigzag(uint64 v) {
+            return int64(v >> 1) ^ -int64(v & 1);
+        }
+
+        /// Reads records from memory, every Get returns false at the end of data
+        struct Cursor {
+            const uint8 *p, *end;
+
+            bool getByte(uint8 *b) {
+                if (p >= end)
+                    return false;
+                *b = *p++;
+                return true;
+            }
+
+            bool getVarint(uint64 *v) {
+                *v = 0;
+                for (int shift = 0; shift < 64; shift += 7) {
+                    uint8 b;
+                    if (!getByte(&b))
+                        return false;
+                    *v |= uint64(b & 0x7f) << shift;
+                    if (!(b & 0x80))
+                        return true;
+                }
+                return false;
+            }
+
+            bool getString(std::string *s) {
+                uint64 n;
+                if (!getVarint(&n) || n > uint64(end - p))
+                    return false;
+                s->assign(reinterpret_cast<const char *>(p), n);
+                p += n;
+                return true;
+            }
+        };
+
+        //==============================================================================
+        /// Codec for a plain number type: raw little-endian bytes
+        template<typename T>
+        PacketCodec numberCodec(const std::string &name) {
+            PacketCodec codec;
+            codec.name = name;
+            codec.matches = [](const Packet &p) { return p.ValidateAsType<T>().ok(); };
+            codec.encode = [](const Packet &p, std::string *s) {
+                T v = p.Get<T>();
+                s->assign(reinterpret_cast<const char *>(&v), sizeof(T));
+            };
+            codec.decode = [](const std::string &s, Packet *p) {
+                T v;
+                if (s.size() != sizeof(T))
+                    return false;
+                std::memcpy(&v, s.data(), sizeof(T));
+                *p = MakePacket<T>(v);
+                return true;
+            };
+            return codec;
+        }
+
+        /// Codec for a protobuf message type
+        template<typename T>
+        PacketCodec protoCodec(const std::string &name) {
+            PacketCodec codec;
+            codec.name = name;
+            codec.matches = [](const Packet &p) { return p.ValidateAsType<T>().ok(); };
+            codec.encode = [](const Packet &p, std::string *s) { p.Get<T>().SerializeToString(s); };
+            codec.decode = [](const std::string &s, Packet *p) {
+                T msg;
+                if (!msg.ParseFromString(s))
+                    return false;
+                *p = MakePacket<T>(msg);
+                return true;
+            };
+            return codec;
+        }
+
+        std::vector<PacketCodec> &codecs() {
+            static std::vector<PacketCodec> list = [] {
+                std::vector<PacketCodec> l;
+                l.push_back(numberCodec<double>("double"));
+                l.push_back(numberCodec<float>("float"));
+                l.push_back(numberCodec<int>("int"));
+                l.push_back(numberCodec<int64>("int64"));
+                l.push_back(numberCodec<bool>("bool"));
+                PacketCodec str;
+                str.name = "string";
+                str.matches = [](const Packet &p) { return p.ValidateAsType<std::string>().ok(); };
+                str.encode = [](const Packet &p, std::string *s) { *s = p.Get<std::string>(); };
+                str.decode = [](const std::string &s, Packet *p) {
+                    *p = MakePacket<std::string>(s);
+                    return true;
+                };
+                l.push_back(str);
+                l.push_back(protoCodec<Rect>("Rect"));
+                l.push_back(protoCodec<NormalizedRect>("NormalizedRect"));
+                return l;
+            }();
+            return list;
+        }
+    }
+
+    //==============================================================================
+    void RegisterPacketCodec(const PacketCodec &codec) {
+        codecs().push_back(codec);
+    }
+
+    //==============================================================================
+    const PacketCodec *FindPacketCodec(const std::string &name) {
+        for (const PacketCodec &c : codecs())
+            if (c.name == name)
+                return &c;
+        return nullptr;
+    }
+
+    //==============================================================================
+    const PacketCodec *FindPacketCodecFor(const Packet &packet) {
+        for (const PacketCodec &c : codecs())
+            if (c.matches(packet))
+                return &c;
+        return nullptr;
+    }
+
+    //==============================================================================
+    PacketTraceRecorder::~PacketTraceRecorder() {
+        Close().IgnoreError();
+    }
+
+    //==============================================================================
+    Status PacketTraceRecorder::Open(const std::string &path) {
+        std::lock_guard<std::mutex> lock(mutexFile);
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return absl::NotFoundError("Cannot create file " + path);
+        // A big buffer: Record() is called on the feeding threads, it should rarely hit the disk
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        startUs = nowUs();
+        lastArrivalUs = 0;
+        numPackets = 0;
+        streams.clear();
+        int64 wallUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        if (std::fwrite(kMagic, sizeof(kMagic), 1, file) != 1 || std::fwrite(&wallUs, sizeof(wallUs), 1, file) != 1)
+            return absl::InternalError("Cannot write trace header !");
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status PacketTraceRecorder::Record(const std::string &streamName, const Packet &packet) {
+        int64 arrivalUs = nowUs() - startUs;
+        std::lock_guard<std::mutex> lock(mutexFile);
+        if (file == nullptr)
+            return absl::FailedPreconditionError("PacketTraceRecorder is not open !");
+        record.clear();
+
+        // A new stream: choose the codec by the first packet, and define the stream in the file
+        auto it = streams.find(streamName);
+        if (it == streams.end()) {
+            const PacketCodec *codec = FindPacketCodecFor(packet);
+            if (codec == nullptr)
+                return absl::InvalidArgumentError("PacketTraceRecorder : no codec for type " +
+                                                  packet.DebugTypeName() + " in stream " + streamName);
+            it = streams.emplace(streamName, StreamState{streams.size(), codec, 0}).first;
+            record.push_back(char(kRecordStream));
+            putVarint(&record, it->second.id);
+            putString(&record, streamName);
+            putString(&record, codec->name);
+        }
+        StreamState &stream = it->second;
+        if (!stream.codec->matches(packet))
+            return absl::InvalidArgumentError("PacketTraceRecorder : wrong type " + packet.DebugTypeName() +
+                                              " in stream " + streamName);
+
+        // Threads can race between nowUs() and the lock, arrival times must not go back
+        arrivalUs = std::max(arrivalUs, lastArrivalUs);
+        int64 ts = packet.Timestamp().Value();
+        payload.clear();
+        stream.codec->encode(packet, &payload);
+        record.push_back(char(kRecordPacket));
+        putVarint(&record, stream.id);
+        putVarint(&record, zigzag(int64(uint64(ts) - uint64(stream.lastTs))));
+        putVarint(&record, uint64(arrivalUs - lastArrivalUs));
+        putString(&record, payload);
+        stream.lastTs = ts;
+        lastArrivalUs = arrivalUs;
+        numPackets++;
+        if (std::fwrite(record.data(), record.size(), 1, file) != 1)
+            return absl::InternalError("Cannot write trace record !");
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status PacketTraceRecorder::AddPacketToInputStream(CalculatorGraph *graph, const std::string &streamName,
+                                                       const Packet &packet) {
+        MP_RETURN_IF_ERROR(Record(streamName, packet));
+        return graph->AddPacketToInputStream(streamName, packet);
+    }
+
+    //==============================================================================
+    Status PacketTraceRecorder::Close() {
+        std::lock_guard<std::mutex> lock(mutexFile);
+        if (file == nullptr)
+            return OkStatus();
+        bool ok = std::fclose(file) == 0;
+        file = nullptr;
+        return ok ? OkStatus() : absl::InternalError("Cannot finalize trace file !");
+    }
+
+    //==============================================================================
+    Status PacketTraceReplayer::Open(const std::string &path) {
+        FILE *file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr)
+            return absl::NotFoundError("Cannot open file " + path);
+        std::vector<uint8> data;
+        uint8 buf[65536];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), file)) > 0)
+            data.insert(data.end(), buf, buf + n);
+        std::fclose(file);
+        if (data.size() < sizeof(kMagic) + sizeof(int64) || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0)
+            return absl::InvalidArgumentError("Bad trace file " + path);
+
+        struct Stream {
+            const PacketCodec *codec;
+            int64 lastTs;
+        };
+        std::vector<Stream> streams;
+        streamNames.clear();
+        packets.clear();
+        int64 arrivalUs = 0;
+        std::string name, codecName, payload;
+        Cursor c{data.data() + sizeof(kMagic) + sizeof(int64), data.data() + data.size()};
+        uint8 type;
+        while (c.getByte(&type)) {
+            uint64 id, tsDelta, arrivalDelta;
+            if (type == kRecordStream) {
+                if (!c.getVarint(&id) || !c.getString(&name) || !c.getString(&codecName))
+                    break;  // Cut at the end, keep what we have
+                const PacketCodec *codec = FindPacketCodec(codecName);
+                if (codec == nullptr)
+                    return absl::InvalidArgumentError("Trace : unknown codec " + codecName + " for stream " + name);
+                if (id != streams.size())
+                    return absl::InvalidArgumentError("Bad trace file " + path);
+                streams.push_back(Stream{codec, 0});
+                streamNames.push_back(name);
+            } else if (type == kRecordPacket) {
+                if (!c.getVarint(&id) || !c.getVarint(&tsDelta) || !c.getVarint(&arrivalDelta) ||
+                    !c.getString(&payload))
+                    break;
+                if (id >= streams.size())
+                    return absl::InvalidArgumentError("Bad trace file " + path);
+                Stream &s = streams[id];
+                s.lastTs = int64(uint64(s.lastTs) + uint64(unzigzag(tsDelta)));
+                arrivalUs += arrivalDelta;
+                Packet packet;
+                if (!s.codec->decode(payload, &packet))
+                    return absl::InvalidArgumentError("Trace : cannot decode a packet of stream " + streamNames[id]);
+                packets.push_back(TracePacket{int(id), arrivalUs, packet.At(Timestamp(s.lastTs))});
+            } else {
+                return absl::InvalidArgumentError("Bad trace file " + path);
+            }
+        }
+        return OkStatus();
+    }
+
+    //==============================================================================
+    Status PacketTraceReplayer::Run(CalculatorGraph *graph, bool realTime) {
+        using namespace std::chrono;
+        maxLagUs = 0;
+        auto t0 = steady_clock::now();
+        for (const TracePacket &tp : packets) {
+            if (realTime) {
+                auto t = t0 + microseconds(tp.arrivalUs);
+                std::this_thread::sleep_until(t);
+                maxLagUs = std::max<int64>(maxLagUs, duration_cast<microseconds>(steady_clock::now() - t).count());
+            }
+            MP_RETURN_IF_ERROR(graph->AddPacketToInputStream(streamNames[tp.streamIndex], tp.packet));
+        }
+        return OkStatus();
+    }
+}
+//==============================================================================
@@ -0,0 +1,124 @@
+#pragma once
+// Packet trace: record graph input packets of any (registered) type to a file, replay them later
+
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Serializes packets of one type
+    struct PacketCodec {
+        std::string name;                                           /// Stored in the file, e.g. "double"
+        std::function<bool(const Packet &)> matches;                /// Does the packet hold our type ?
+        std::function<void(const Packet &, std::string *)> encode;  /// Payload of a packet
+        std::function<bool(const std::string &, Packet *)> decode;  /// Payload to packet (no timestamp)
+    };
+
+    /// Built-in codecs: double, float, int, int64, bool, std::string, Rect, NormalizedRect
+    /// Add other types with RegisterPacketCodec() before recording or replaying (not thread-safe)
+    void RegisterPacketCodec(const PacketCodec &codec);
+
+    /// Find a codec by name, nullptr if unknown
+    const PacketCodec *FindPacketCodec(const std::string &name);
+
+    /// Find a codec for the type of packet, nullptr if none
+    const PacketCodec *FindPacketCodecFor(const Packet &packet);
+
+    /// A typed shortcut for RegisterPacketCodec()
+    template<typename T>
+    void RegisterPacketCodec(const std::string &name, std::function<void(const T &, std::string *)> enc,
+                             std::function<bool(const std::string &, T *)> dec) {
+        PacketCodec codec;
+        codec.name = name;
+        codec.matches = [](const Packet &p) { return p.ValidateAsType<T>().ok(); };
+        codec.encode = [enc](const Packet &p, std::string *s) { enc(p.Get<T>(), s); };
+        codec.decode = [dec](const std::string &s, Packet *p) {
+            T value;
+            if (!dec(s, &value))
+                return false;
+            *p = MakePacket<T>(std::move(value));
+            return true;
+        };
+        RegisterPacketCodec(codec);
+    }
+
+    //==============================================================================
+    /// Trace file layout: header {"MPTRACE1", int64 wall clock start time in us}, then records:
+    /// STREAM: 1, varint id, string stream name, string codec name (once per stream, before its packets)
+    /// PACKET: 2, varint id, zigzag varint timestamp delta (from the previous packet of this stream),
+    ///         varint arrival time delta (from the previous packet), string payload
+    /// A string is a varint length and bytes, arrival times are in us since the start
+    /// The file is append-only, so a trace cut by a crash is still readable up to the last full record
+
+    /// Records packets, thread-safe: several threads can feed the graph
+    class PacketTraceRecorder {
+    public:
+        ~PacketTraceRecorder();
+
+        Status Open(const std::string &path);
+
+        /// Record a packet, arriving now, of the graph input stream streamName
+        Status Record(const std::string &streamName, const Packet &packet);
+
+        /// Record, then send to the graph: use instead of graph->AddPacketToInputStream()
+        Status AddPacketToInputStream(CalculatorGraph *graph, const std::string &streamName, const Packet &packet);
+
+        /// Flush and close the file
+        Status Close();
+
+        int64 NumPackets() const { return numPackets; }
+
+    private:
+        struct StreamState {
+            uint64 id;
+            const PacketCodec *codec;
+            int64 lastTs;
+        };
+
+        std::mutex mutexFile;
+        FILE *file = nullptr;
+        int64 startUs = 0, lastArrivalUs = 0, numPackets = 0;
+        std::map<std::string, StreamState> streams;
+        std::string record, payload;
+    };
+
+    //==============================================================================
+    /// Loads a trace and replays it into a graph
+    class PacketTraceReplayer {
+    public:
+        /// Read and decode the whole trace, so that replay does not touch the disk or decode
+        Status Open(const std::string &path);
+
+        /// Input streams in the trace, the graph must have them all
+        const std::vector<std::string> &StreamNames() const { return streamNames; }
+
+        int64 NumPackets() const { return packets.size(); }
+
+        /// Feed all packets to graph: with the original timing (relative to now), or as fast as possible
+        /// Does not close the input streams
+        Status Run(CalculatorGraph *graph, bool realTime);
+
+        /// After Run(): the worst lag behind the original timing, it shows if the replay is faithful
+        int64 MaxLagUs() const { return maxLagUs; }
+
+    private:
+        struct TracePacket {
+            int streamIndex;
+            int64 arrivalUs;
+            Packet packet;
+        };
+
+        std::vector<std::string> streamNames;
+        std::vector<TracePacket> packets;
+        int64 maxLagUs = 0;
+    };
+}
+//==============================================================================
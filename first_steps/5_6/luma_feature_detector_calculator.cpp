@@ -0,0 +1,47 @@
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_features2d_inc.h"
+
+#include "mediapipe/examples/first_steps/5_6/luma_feature_detector_calculator.pb.h"
+#include "mediapipe/examples/first_steps/5_6/yuv_image.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// ORB keypoints, as FeatureDetectorCalculator in 2.4, but on a YuvImage:
+    /// ORB works on grayscale anyway, so it takes the Y plane as is, with no colour conversion
+    /// Input: IMAGE (YuvImage), output: FEATURES (std::vector<cv::KeyPoint>)
+    class LumaFeatureDetectorCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<YuvImage>();
+            cc->Outputs().Tag("FEATURES").Set<std::vector<cv::KeyPoint>>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            const auto &options = cc->Options<LumaFeatureDetectorCalculatorOptions>();
+            orb = cv::ORB::create(options.max_features(), options.scale_factor(), options.pyramid_level());
+            cc->SetOffset(0);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            const YuvImage &yuv = cc->Inputs().Tag("IMAGE").Get<YuvImage>();
+            cv::Mat luma = formats::MatView(&yuv.Y());
+            std::vector<cv::KeyPoint> *kps = new std::vector<cv::KeyPoint>();
+            orb->detect(luma, *kps);
+            cc->Outputs().Tag("FEATURES").Add(kps, cc->InputTimestamp());
+            return OkStatus();
+        }
+
+    private:
+        cv::Ptr<cv::ORB> orb;
+    };
+    REGISTER_CALCULATOR(LumaFeatureDetectorCalculator);
+}
+//==============================================================================
@@ -0,0 +1,188 @@
+/// Example 5.6 : Native YUV ingest
+/// By Oleksiy Grechnyev, IT-JIM
+/// Cameras give YUV. In 2.4, OpenCV converts it to BGR, the camera loop converts BGR to RGB,
+/// and then FeatureDetectorCalculator converts RGB to grayscale: three colour conversions per frame,
+/// while ORB only needs the luma (Y), which the camera gave us for free
+/// Here ("yuv" mode) the camera gives raw YUYV (CAP_PROP_CONVERT_RGB = 0), which we split into
+/// NV12 planes: YuvImage (yuv_image.h), two GRAY8 ImageFrames
+/// LumaFeatureDetectorCalculator detects ORB keypoints on the Y plane directly, and YuvToRgbCalculator
+/// gives RGB (converted lazily, at most once per frame) only to DrawFeatCalculator24, which needs it
+/// "rgb" mode is the graph of 2.4 for comparison
+/// We print the average ingest time (frame -> packet) and the graph FPS
+/// Usage: 5_6 [yuv|rgb]
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/port/opencv_video_inc.h"
+
+#include "mediapipe/examples/first_steps/5_6/yuv_image.h"
+
+//==============================================================================
+mediapipe::Status run(bool useYuv) {
+    using namespace std;
+    using namespace mediapipe;
+
+    string protoG;
+    if (useYuv)
+        protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "LumaFeatureDetectorCalculator"
+            input_stream: "IMAGE:in"
+            output_stream: "FEATURES:feat"
+            options : {
+                [mediapipe.LumaFeatureDetectorCalculatorOptions.ext] {
+                    max_features : 1000
+                }
+            }
+        }
+        node {
+            calculator: "YuvToRgbCalculator"
+            input_stream: "YUV:in"
+            output_stream: "IMAGE:rgb"
+        }
+        node {
+            calculator: "DrawFeatCalculator24"
+            input_stream: "IMAGE:rgb"
+            input_stream: "FEATURES:feat"
+            output_stream: "IMAGE:out"
+        }
+        )";
+    else
+        protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "FeatureDetectorCalculator"
+            input_stream: "IMAGE:in"
+            output_stream: "FEATURES:feat"
+            options : {
+                [mediapipe.FeatureDetectorCalculatorOptions.ext] {
+                    max_features : 1000
+                }
+            }
+        }
+        node {
+            calculator: "DrawFeatCalculator24"
+            input_stream: "IMAGE:in"
+            input_stream: "FEATURES:feat"
+            output_stream: "IMAGE:out"
+        }
+        )";
+
+    // Parse config and create graph
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    // Mutex protecting imshow() and the stop flag
+    mutex mutexImshow;
+    atomic_bool flagStop(false);
+    atomic_int numOut(0);
+
+    // This callback displays the frame on the screen
+    auto cb = [&mutexImshow, &flagStop, &numOut](const Packet &packet)->Status{
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        numOut++;
+        {
+            lock_guard<mutex> lock(mutexImshow);
+            // Display frame on screen and quit on ESC
+            cv::imshow("frameOut", frameOut);
+            if (27 == cv::waitKey(1)){
+                cout << "It's time to QUIT !" << endl;
+                flagStop = true;
+            }
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // Start the camera and check that it works
+    // For YUV: ask for YUYV (most USB cameras have it), and no conversion to BGR
+    cv::VideoCapture cap(cv::CAP_ANY);
+    if (!cap.isOpened())
+        return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    if (useYuv) {
+        cap.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('Y', 'U', 'Y', 'V'));
+        cap.set(cv::CAP_PROP_CONVERT_RGB, 0);
+    }
+    int width = int(cap.get(cv::CAP_PROP_FRAME_WIDTH));
+    int height = int(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+    cv::Mat frameIn, frameInRGB;
+
+    // Camera loop, runs until we get flagStop == true
+    double ingestSec = 0;
+    auto t0 = chrono::steady_clock::now();
+    int i;
+    for (i = 0; !flagStop; ++i) {
+        // Read next frame from camera
+        cap.read(frameIn);
+        if (frameIn.empty())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+
+        // Convert it to a packet and send
+        auto t1 = chrono::steady_clock::now();
+        Packet packet;
+        if (useYuv) {
+            unique_ptr<YuvImage> yuv;
+            MP_RETURN_IF_ERROR(YuvImage::FromCameraFrame(frameIn, width, height, &yuv));
+            packet = Adopt(yuv.release());
+        } else {
+            cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+            ImageFrame *inputFrame = new ImageFrame(
+                ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary
+            );
+            frameInRGB.copyTo(formats::MatView(inputFrame));
+            packet = Adopt(inputFrame);
+        }
+        ingestSec += chrono::duration<double>(chrono::steady_clock::now() - t1).count();
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", packet.At(Timestamp(i))));
+
+        if (i % 100 == 99) {
+            double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            cout << (useYuv ? "YUV" : "RGB") << " : ingest " << 1000 * ingestSec / (i + 1) << " ms/frame, output "
+                 << numOut / sec << " FPS, RGB conversions (YuvImage) = " << YuvImage::NumRgbConversions() << endl;
+        }
+    }
+    // Close the input streams, Wait for the graph to finish
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 5.6 : Native YUV ingest" << endl;
+    bool useYuv = !(argc > 1 && string(argv[1]) == "rgb");
+    mediapipe::Status status = run(useYuv);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
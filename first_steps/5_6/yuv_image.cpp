@@ -0,0 +1,68 @@
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/5_6/yuv_image.h"
+
+//==============================================================================
+namespace mediapipe {
+    std::atomic<int64> YuvImage::numRgbConversions(0);
+
+    //==============================================================================
+    Status YuvImage::FromCameraFrame(const cv::Mat &raw, int width, int height, std::unique_ptr<YuvImage> *out) {
+        if (width % 2 != 0 || height % 2 != 0)
+            return absl::InvalidArgumentError("YuvImage : width and height must be even !");
+        if (!raw.isContinuous())
+            return absl::InvalidArgumentError("YuvImage : the raw frame must be continuous !");
+        size_t bytes = raw.total() * raw.elemSize();
+        std::unique_ptr<ImageFrame> y(new ImageFrame(ImageFormat::GRAY8, width, height,
+                                                     ImageFrame::kDefaultAlignmentBoundary));
+        std::unique_ptr<ImageFrame> uv;
+        if (raw.type() == CV_8UC3 && raw.cols == width && raw.rows == height) {
+            // Fallback: the backend gave us BGR, make NV12 from I420
+            cv::Mat i420;
+            cv::cvtColor(raw, i420, cv::COLOR_BGR2YUV_I420);
+            i420.rowRange(0, height).copyTo(formats::MatView(y.get()));
+            uv.reset(new ImageFrame(ImageFormat::GRAY8, width, height / 2, ImageFrame::kDefaultAlignmentBoundary));
+            cv::Mat u(height / 2, width / 2, CV_8UC1, i420.ptr(height));
+            cv::Mat v(height / 2, width / 2, CV_8UC1, i420.ptr(height) + width * height / 4);
+            cv::Mat uvView(height / 2, width / 2, CV_8UC2, uv->MutablePixelData(), uv->WidthStep());
+            cv::merge(std::vector<cv::Mat>{u, v}, uvView);
+        } else if (bytes == size_t(width) * height * 2) {
+            // YUYV = Y0 U0 Y1 V0: channel 0 is Y, channel 1 is U0 V0 U1 V1 ..., an NV12 row of UV
+            cv::Mat yuyv(height, width, CV_8UC2, const_cast<uint8 *>(raw.ptr()));
+            cv::Mat yView = formats::MatView(y.get());
+            cv::extractChannel(yuyv, yView, 0);
+            uv.reset(new ImageFrame(ImageFormat::GRAY8, width, height / 2, ImageFrame::kDefaultAlignmentBoundary));
+            cv::Mat uvView = formats::MatView(uv.get());
+            for (int r = 0; r < height / 2; ++r) {
+                cv::Mat dst = uvView.row(r);
+                cv::extractChannel(yuyv.row(2 * r), dst, 1);
+            }
+        } else if (bytes == size_t(width) * height * 3 / 2) {
+            // NV12: copy the buffer once (the camera reuses it), both planes point into the copy
+            cv::Mat copy = raw.clone();
+            uint8 *data = copy.ptr();
+            y.reset(new ImageFrame(ImageFormat::GRAY8, width, height, width, data, [copy](uint8 *) {}));
+            uv.reset(new ImageFrame(ImageFormat::GRAY8, width, height / 2, width, data + width * height,
+                                    [copy](uint8 *) {}));
+        } else {
+            return absl::InvalidArgumentError("YuvImage : unknown raw frame format, set the camera to YUYV or NV12 !");
+        }
+        out->reset(new YuvImage(std::move(y), std::move(uv)));
+        return OkStatus();
+    }
+
+    //==============================================================================
+    const ImageFrame &YuvImage::Rgb() const {
+        std::call_once(onceRgb, [this] {
+            rgb.reset(new ImageFrame(ImageFormat::SRGB, Width(), Height(), ImageFrame::kDefaultAlignmentBoundary));
+            cv::Mat rgbView = formats::MatView(rgb.get());
+            // The UV plane is stored as GRAY8 (w x h/2), OpenCV wants interleaved pairs: (w/2 x h/2) CV_8UC2
+            cv::Mat uvView(Height() / 2, Width() / 2, CV_8UC2, uv->MutablePixelData(), uv->WidthStep());
+            cv::cvtColorTwoPlane(formats::MatView(y.get()), uvView, rgbView, cv::COLOR_YUV2RGB_NV12);
+            numRgbConversions++;
+        });
+        return *rgb;
+    }
+}
+//==============================================================================
@@ -0,0 +1,56 @@
+#pragma once
+// A camera frame in native YUV (NV12 planes in ImageFrames), with RGB made lazily on demand
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// NV12 image: the Y plane (GRAY8 ImageFrame, width x height),
+    /// and the interleaved UV plane (GRAY8 ImageFrame, width x height/2: U0 V0 U1 V1 ...)
+    /// Luma-only consumers (feature detectors, ...) take Y(), which needs no conversion at all
+    /// Rgb() converts to an SRGB ImageFrame on the first call only, and caches it (thread-safe),
+    /// so no matter how many calculators need RGB, a frame is converted at most once, and never if none does
+    class YuvImage {
+    public:
+        YuvImage(std::unique_ptr<ImageFrame> y, std::unique_ptr<ImageFrame> uv) : y(std::move(y)), uv(std::move(uv)) {}
+
+        YuvImage(const YuvImage &) = delete;
+
+        YuvImage &operator=(const YuvImage &) = delete;
+
+        /// Convert a raw camera frame (cv::VideoCapture with CAP_PROP_CONVERT_RGB = 0), by its size:
+        /// YUYV (width*height*2 bytes): Y and UV are split in one pass, UV takes every second row (4:2:2 -> 4:2:0)
+        /// NV12 (width*height*3/2 bytes): one copy of the buffer, the planes point into it
+        /// BGR (CV_8UC3, if the backend ignores CONVERT_RGB): converted, only as a fallback
+        static Status FromCameraFrame(const cv::Mat &raw, int width, int height, std::unique_ptr<YuvImage> *out);
+
+        int Width() const { return y->Width(); }
+
+        int Height() const { return y->Height(); }
+
+        const ImageFrame &Y() const { return *y; }
+
+        const ImageFrame &UV() const { return *uv; }
+
+        /// SRGB image, converted on the first call
+        const ImageFrame &Rgb() const;
+
+        /// RGB conversions done by all YuvImage objects so far
+        static int64 NumRgbConversions() { return numRgbConversions; }
+
+    private:
+        std::unique_ptr<ImageFrame> y, uv;
+        mutable std::once_flag onceRgb;
+        mutable std::unique_ptr<ImageFrame> rgb;
+        static std::atomic<int64> numRgbConversions;
+    };
+}
+//==============================================================================
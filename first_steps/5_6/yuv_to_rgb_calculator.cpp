@@ -0,0 +1,37 @@
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/5_6/yuv_image.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// The adapter for calculators which need RGB: YuvImage -> SRGB ImageFrame
+    /// The output frame points to the (lazily converted) YuvImage::Rgb() pixels, no copying:
+    /// its deleter keeps the input packet alive
+    /// Put it only before the nodes which need RGB, the rest of the graph stays in YUV
+    class YuvToRgbCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("YUV").Set<YuvImage>();
+            cc->Outputs().Tag("IMAGE").Set<ImageFrame>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            cc->SetOffset(0);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            Packet pIn = cc->Inputs().Tag("YUV").Value();
+            const ImageFrame &rgb = pIn.Get<YuvImage>().Rgb();
+            ImageFrame *frame = new ImageFrame(rgb.Format(), rgb.Width(), rgb.Height(), rgb.WidthStep(),
+                                               const_cast<uint8 *>(rgb.PixelData()), [pIn](uint8 *) {});
+            cc->Outputs().Tag("IMAGE").Add(frame, cc->InputTimestamp());
+            return OkStatus();
+        }
+    };
+    REGISTER_CALCULATOR(YuvToRgbCalculator);
+}
+//==============================================================================
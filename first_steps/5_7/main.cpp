@@ -0,0 +1,192 @@
+/// Example 5.7 : Shared-memory bridge between processes
+/// By Oleksiy Grechnyev, IT-JIM
+/// Here a pipeline is split between two processes (two graphs): the producer process captures the camera,
+/// the consumer process receives and displays the frames; a crash of one does not take down the other,
+/// and each can run on its own CPU set (taskset -c ...)
+/// ShmBridgeSendCalculator ends the producer graph, ShmBridgeReceiveCalculator (a source) starts the consumer one,
+/// they talk through ShmRing (shm_ring.h), a ring in POSIX shared memory
+/// Zero copy: the camera frames are allocated right in the shared memory slots (ShmRing::NewFrame()),
+/// only a slot handle with the timestamp goes through the ring, the consumer gets ImageFrame views of the slots
+/// Timestamps (capture time, monotonic clock, the same in both processes) and timestamp bounds are preserved
+/// The consumer displays the end-to-end latency (capture -> display) and prints the transport latency
+/// "both" : fork, the child is the consumer; or run "send" and "recv" in two terminals
+/// ESC in the consumer window stops both
+/// Usage: 5_7 [both|send|recv] [ring_name=/mp_5_7]
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/port/opencv_video_inc.h"
+
+#include "mediapipe/examples/first_steps/5_7/shm_ring.h"
+
+//==============================================================================
+/// The producer process: camera -> ShmBridgeSendCalculator
+mediapipe::Status runSend(const std::string &name) {
+    using namespace std;
+    using namespace mediapipe;
+
+    string protoG = R"(
+        input_stream: "in"
+        input_side_packet: "ring"
+        node {
+            calculator: "ShmBridgeSendCalculator"
+            input_stream: "IMAGE:in"
+            input_side_packet: "RING:ring"
+        }
+        )";
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    // Start the camera, the slot size comes from the first frame
+    cv::VideoCapture cap(cv::CAP_ANY);
+    if (!cap.isOpened())
+        return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    cv::Mat frameIn;
+    cap.read(frameIn);
+    if (frameIn.empty())
+        return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    uint64 slotBytes = uint64(frameIn.cols * 3 + ImageFrame::kDefaultAlignmentBoundary) * frameIn.rows;
+    shared_ptr<ShmRing> ring = ShmRing::Create(name, 8, slotBytes);
+    if (!ring)
+        return absl::InternalError("Cannot create shared memory " + name);
+    MP_RETURN_IF_ERROR(graph.StartRun({{"ring", MakePacket<shared_ptr<ShmRing>>(ring)}}));
+
+    // Camera loop, runs until the consumer closes
+    int numCopied = 0;
+    while (!ring->ConsumerClosed()) {
+        cap.read(frameIn);
+        if (frameIn.empty())
+            break;
+        int64 ts = ShmRing::NowUs();
+        // The frame is allocated in shared memory, cvtColor writes there directly
+        // No free slot (the consumer is slow or dead): a usual frame, ShmBridgeSendCalculator waits
+        // up to max_wait_ms for a slot and copies it there, the frame is dropped only if none frees up
+        unique_ptr<ImageFrame> inputFrame = ring->NewFrame(ImageFormat::SRGB, frameIn.cols, frameIn.rows, 10);
+        if (!inputFrame) {
+            inputFrame.reset(new ImageFrame(ImageFormat::SRGB, frameIn.cols, frameIn.rows,
+                                            ImageFrame::kDefaultAlignmentBoundary));
+            numCopied++;
+        }
+        cv::Mat ifMat = formats::MatView(inputFrame.get());
+        cv::cvtColor(frameIn, ifMat, cv::COLOR_BGR2RGB);
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", Adopt(inputFrame.release()).At(Timestamp(ts))));
+    }
+    cout << "PRODUCER : " << numCopied << " frames had no free slot" << endl;
+    graph.CloseInputStream("in");
+    return graph.WaitUntilDone();
+}
+
+//==============================================================================
+/// The consumer process: ShmBridgeReceiveCalculator -> display
+mediapipe::Status runRecv(const std::string &name) {
+    using namespace std;
+    using namespace mediapipe;
+
+    string protoG = R"(
+        input_side_packet: "ring"
+        output_stream: "out"
+        node {
+            calculator: "ShmBridgeReceiveCalculator"
+            input_side_packet: "RING:ring"
+            output_stream: "IMAGE:out"
+        }
+        )";
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    // Wait for the producer to create the ring
+    shared_ptr<ShmRing> ring = ShmRing::Open(name, 10000);
+    if (!ring)
+        return absl::NotFoundError("Cannot open shared memory " + name + ", is the producer running ?");
+
+    atomic_bool flagStop(false);
+
+    // The observer displays the frame (still in shared memory) with the end-to-end latency
+    auto cb = [&flagStop](const Packet &packet)->Status{
+        double latencyMs = (ShmRing::NowUs() - packet.Timestamp().Value()) / 1000.;
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        string text = "capture -> display " + to_string(latencyMs).substr(0, 5) + " ms";
+        cv::putText(frameOut, text, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 255, 0), 2);
+        cv::imshow("frameOut", frameOut);
+        if (27 == cv::waitKey(1)){
+            cout << "It's time to QUIT !" << endl;
+            flagStop = true;
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({{"ring", MakePacket<shared_ptr<ShmRing>>(ring)}}));
+
+    // When the producer closes, the source stops by itself after the remaining messages
+    while (!flagStop && !ring->ProducerClosed())
+        this_thread::sleep_for(chrono::milliseconds(100));
+    if (flagStop)
+        MP_RETURN_IF_ERROR(graph.CloseAllPacketSources());
+    return graph.WaitUntilDone();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 5.7 : Shared-memory bridge between processes" << endl;
+    string mode = argc > 1 ? argv[1] : "both";
+    string name = argc > 2 ? argv[2] : "/mp_5_7";
+    mediapipe::Status status;
+    if (mode == "send") {
+        status = runSend(name);
+    } else if (mode == "recv") {
+        status = runRecv(name);
+    } else if (mode == "both") {
+        // Fork before any graph or thread exists
+        pid_t pid = fork();
+        if (pid < 0) {
+            cout << "fork() failed" << endl;
+            return 1;
+        }
+        if (pid == 0) {
+            status = runRecv(name);
+            cout << "CONSUMER status =" << status << endl;
+            return 0;
+        }
+        status = runSend(name);
+        waitpid(pid, nullptr, 0);
+    } else {
+        cout << "Usage: 5_7 [both|send|recv] [ring_name=/mp_5_7]" << endl;
+        return 1;
+    }
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/5_7/shm_ring.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// A source calculator in the consumer process: outputs the IMAGE packets of ShmBridgeSendCalculator
+    /// from the side packet RING (std::shared_ptr<ShmRing>, made by ShmRing::Open())
+    /// Frames are NOT copied: each ImageFrame is a view of a shared memory slot, the slot is given back
+    /// to the producer when the last packet holding the frame is destroyed
+    /// Packets keep their timestamps, timestamp bounds are forwarded, the graph stops (StatusStop)
+    /// when the producer closes; stop it earlier with CalculatorGraph::CloseAllPacketSources()
+    /// The transport latency (send -> receive) is printed in Close()
+    class ShmBridgeReceiveCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Outputs().Tag("IMAGE").Set<ImageFrame>();
+            cc->InputSidePackets().Tag("RING").Set<std::shared_ptr<ShmRing>>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            ring = cc->InputSidePackets().Tag("RING").Get<std::shared_ptr<ShmRing>>();
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            // Nothing yet: return, MediaPipe calls a source again
+            ShmMessage msg;
+            if (!ring->Receive(&msg, 100))
+                return OkStatus();
+            switch (msg.kind) {
+                case ShmMessageKind::PACKET: {
+                    std::unique_ptr<ImageFrame> frame = ring->FrameOf(msg);
+                    if (!frame)
+                        return absl::InternalError("ShmBridgeReceiveCalculator : bad message");
+                    latenciesUs.push_back(double(ShmRing::NowUs() - msg.sendUs));
+                    cc->Outputs().Tag("IMAGE").Add(frame.release(), Timestamp(msg.timestamp));
+                    break;
+                }
+                case ShmMessageKind::BOUND:
+                    cc->Outputs().Tag("IMAGE").SetNextTimestampBound(Timestamp(msg.timestamp));
+                    break;
+                case ShmMessageKind::CLOSE:
+                    return tool::StatusStop();
+            }
+            return OkStatus();
+        }
+
+        Status Close(CalculatorContext *cc) override {
+            using namespace std;
+            ring->CloseConsumer();
+            if (latenciesUs.empty())
+                return OkStatus();
+            sort(latenciesUs.begin(), latenciesUs.end());
+            double sum = 0;
+            for (double l : latenciesUs)
+                sum += l;
+            size_t n = latenciesUs.size();
+            cout << "ShmBridgeReceiveCalculator : " << n << " frames, transport latency us: avg = " << sum / n
+                 << " p50 = " << latenciesUs[n / 2] << " p99 = " << latenciesUs[min(n - 1, n * 99 / 100)]
+                 << " max = " << latenciesUs.back() << endl;
+            return OkStatus();
+        }
+
+    private:
+        std::shared_ptr<ShmRing> ring;
+        std::vector<double> latenciesUs;
+    };
+    REGISTER_CALCULATOR(ShmBridgeReceiveCalculator);
+}
+//==============================================================================
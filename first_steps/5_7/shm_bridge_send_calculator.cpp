@@ -0,0 +1,68 @@
+#include <iostream>
+#include <memory>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/5_7/shm_bridge_send_calculator.pb.h"
+#include "mediapipe/examples/first_steps/5_7/shm_ring.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// The end of a graph in the producer process: sends IMAGE packets to ShmBridgeReceiveCalculator
+    /// in another process through the side packet RING (std::shared_ptr<ShmRing>, made by ShmRing::Create())
+    /// Frames allocated with ShmRing::NewFrame() go by slot handle, others are copied to a slot once
+    /// Timestamp bounds without packets are sent too (SetProcessTimestampBounds), so that
+    /// the receiving graph sees the same bounds
+    /// If the receiver is slow or dead, packets are dropped after max_wait_ms: this graph never hangs
+    class ShmBridgeSendCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            cc->InputSidePackets().Tag("RING").Set<std::shared_ptr<ShmRing>>();
+            cc->SetProcessTimestampBounds(true);
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            ring = cc->InputSidePackets().Tag("RING").Get<std::shared_ptr<ShmRing>>();
+            maxWaitMs = cc->Options<ShmBridgeSendCalculatorOptions>().max_wait_ms();
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            Timestamp ts = cc->InputTimestamp();
+            if (cc->Inputs().Tag("IMAGE").IsEmpty()) {
+                // Only the bound has moved, e.g. an upstream node has skipped this frame
+                if (!ring->SendBound(ts.NextAllowedInStream(), maxWaitMs))
+                    numDropped++;
+                return OkStatus();
+            }
+            bool copied = false;
+            if (ring->SendFrame(cc->Inputs().Tag("IMAGE").Get<ImageFrame>(), ts, maxWaitMs, &copied)) {
+                numSent++;
+                if (copied)
+                    numCopied++;
+            } else {
+                numDropped++;
+            }
+            return OkStatus();
+        }
+
+        Status Close(CalculatorContext *cc) override {
+            ring->SendClose(maxWaitMs);
+            std::cout << "ShmBridgeSendCalculator : sent " << numSent << " frames (" << numSent - numCopied
+                      << " zero-copy, " << numCopied << " copied), dropped " << numDropped << std::endl;
+            return OkStatus();
+        }
+
+    private:
+        std::shared_ptr<ShmRing> ring;
+        int maxWaitMs = 50;
+        int64 numSent = 0, numCopied = 0, numDropped = 0;
+    };
+    REGISTER_CALCULATOR(ShmBridgeSendCalculator);
+}
+//==============================================================================
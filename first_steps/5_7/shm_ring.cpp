@@ -0,0 +1,384 @@
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <thread>
+
+#include "mediapipe/examples/first_steps/5_7/shm_ring.h"
+
+//==============================================================================
+namespace mediapipe {
+    // Atomics in shared memory work between processes only if they are lock-free
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "Need lock-free atomics");
+
+    /// At the start of the shared memory, written by Create()
+    struct ShmRing::Header {
+        uint64 magic;
+        uint32 numSlots, numMessages;
+        uint64 slotBytes;
+        uint64 messagesOffset, refsOffset, dataOffset, totalBytes;
+        int32 producerPid;
+        alignas(64) std::atomic<uint64> head;            /// Next message to write, producer only
+        alignas(64) std::atomic<uint64> tail;            /// Next message to read, consumer only
+        alignas(64) std::atomic<uint32> producerEvents;  /// Futex: +1 on each new message
+        alignas(64) std::atomic<uint32> consumerEvents;  /// Futex: +1 when a message is taken or a slot is freed
+        alignas(64) std::atomic<uint32> ready;           /// 1 when Create() has finished
+        std::atomic<uint32> producerClosed, consumerClosed;
+    };
+
+    namespace {
+        constexpr uint64 kMagic = 0x31474e4952534d50ull;   // "PMSRING1"
+        constexpr uint64 kPage = 4096;
+
+        uint64 roundUp(uint64 n, uint64 a) {
+            return (n + a - 1) / a * a;
+        }
+
+        /// Bytes per pixel of the formats ImageFrame supports (it CHECK-fails on the others), 0 if unknown
+        int pixelBytes(int32 format) {
+            switch (format) {
+                case ImageFormat::GRAY8:
+                    return 1;
+                case ImageFormat::GRAY16:
+                    return 2;
+                case ImageFormat::SRGB:
+                case ImageFormat::LAB8:
+                    return 3;
+                case ImageFormat::SRGBA:
+                case ImageFormat::SBGRA:
+                case ImageFormat::VEC32F1:
+                    return 4;
+                case ImageFormat::SRGB48:
+                    return 6;
+                case ImageFormat::SRGBA64:
+                case ImageFormat::VEC32F2:
+                    return 8;
+                default:
+                    return 0;
+            }
+        }
+
+        /// +1 and wake all waiters, in all processes (no FUTEX_PRIVATE_FLAG)
+        void wake(std::atomic<uint32> *word) {
+            word->fetch_add(1, std::memory_order_seq_cst);
+            syscall(SYS_futex, reinterpret_cast<uint32 *>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        }
+
+        /// Wait until ready() or timeout, sleeping on the futex word between the checks
+        template<typename Pred>
+        bool waitFor(std::atomic<uint32> *word, Pred ready, int timeoutMs) {
+            using namespace std::chrono;
+            auto deadline = steady_clock::now() + milliseconds(timeoutMs);
+            for (;;) {
+                // Read the word before the check: a wake() after the check changes it, and FUTEX_WAIT returns
+                uint32 w = word->load(std::memory_order_seq_cst);
+                if (ready())
+                    return true;
+                int64 leftUs = duration_cast<microseconds>(deadline - steady_clock::now()).count();
+                if (leftUs <= 0)
+                    return false;
+                timespec ts{time_t(leftUs / 1000000), long(leftUs % 1000000) * 1000};
+                syscall(SYS_futex, reinterpret_cast<uint32 *>(word), FUTEX_WAIT, w, &ts, nullptr, 0);
+            }
+        }
+    }
+
+    //==============================================================================
+    std::shared_ptr<ShmRing> ShmRing::Create(const std::string &name, int numSlots, uint64 slotBytes,
+                                             int numMessages) {
+        numSlots = std::max(numSlots, 1);
+        numMessages = std::max(numMessages, 2);
+        slotBytes = roundUp(std::max<uint64>(slotBytes, 1), kPage);
+        uint64 messagesOffset = roundUp(sizeof(Header), 64);
+        uint64 refsOffset = roundUp(messagesOffset + numMessages * sizeof(ShmMessage), 64);
+        uint64 dataOffset = roundUp(refsOffset + numSlots * sizeof(std::atomic<uint32>), kPage);
+        uint64 totalBytes = dataOffset + numSlots * slotBytes;
+
+        // A leftover from a crashed run is replaced
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+            return nullptr;
+        if (ftruncate(fd, off_t(totalBytes)) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+        void *p = mmap(nullptr, totalBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+        // The new memory is all zeros: empty queue, all slot reference counts 0
+        Header *h = new(p) Header();
+        h->magic = kMagic;
+        h->numSlots = uint32(numSlots);
+        h->numMessages = uint32(numMessages);
+        h->slotBytes = slotBytes;
+        h->messagesOffset = messagesOffset;
+        h->refsOffset = refsOffset;
+        h->dataOffset = dataOffset;
+        h->totalBytes = totalBytes;
+        h->producerPid = int32(getpid());
+        h->ready.store(1, std::memory_order_release);
+        return std::shared_ptr<ShmRing>(new ShmRing(name, true, static_cast<uint8 *>(p), totalBytes));
+    }
+
+    //==============================================================================
+    std::shared_ptr<ShmRing> ShmRing::Open(const std::string &name, int timeoutMs) {
+        using namespace std::chrono;
+        auto deadline = steady_clock::now() + milliseconds(timeoutMs);
+        for (;;) {
+            int fd = shm_open(name.c_str(), O_RDWR, 0);
+            if (fd >= 0) {
+                struct stat st;
+                if (fstat(fd, &st) == 0 && uint64(st.st_size) >= sizeof(Header)) {
+                    void *p = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                    if (p != MAP_FAILED) {
+                        Header *h = static_cast<Header *>(p);
+                        if (h->ready.load(std::memory_order_acquire) == 1 && h->magic == kMagic &&
+                            h->totalBytes == uint64(st.st_size) && layoutFits(h, uint64(st.st_size)) &&
+                            (kill(h->producerPid, 0) == 0 || errno == EPERM)) {
+                            close(fd);
+                            return std::shared_ptr<ShmRing>(
+                                    new ShmRing(name, false, static_cast<uint8 *>(p), uint64(st.st_size)));
+                        }
+                        munmap(p, st.st_size);
+                    }
+                }
+                close(fd);
+            }
+            // Not created yet, or Create() is not finished
+            if (steady_clock::now() >= deadline)
+                return nullptr;
+            std::this_thread::sleep_for(milliseconds(10));
+        }
+    }
+
+    //==============================================================================
+    bool ShmRing::layoutFits(const Header *h, uint64 size) {
+        // Every offset within the mapping first: the sums below then cannot overflow
+        // (a size is far below 2^63, counts are uint32 and the element sizes are small)
+        if (h->messagesOffset > size || h->refsOffset > size || h->dataOffset > size)
+            return false;
+        // The ring indices are taken modulo these, and a slot must hold something
+        if (h->numSlots < 1 || h->numMessages < 2 || h->slotBytes < 1)
+            return false;
+        // Header, messages, reference counts, slots: in this order, aligned, not overlapping
+        return h->messagesOffset >= sizeof(Header) && h->messagesOffset % alignof(ShmMessage) == 0 &&
+               h->messagesOffset + uint64(h->numMessages) * sizeof(ShmMessage) <= h->refsOffset &&
+               h->refsOffset % alignof(std::atomic<uint32>) == 0 &&
+               h->refsOffset + uint64(h->numSlots) * sizeof(std::atomic<uint32>) <= h->dataOffset &&
+               h->numSlots <= (size - h->dataOffset) / h->slotBytes;
+    }
+
+    //==============================================================================
+    ShmRing::~ShmRing() {
+        // Frames hold a shared_ptr to us, so no slot is in use by this process here
+        munmap(base, size);
+        if (owner)
+            shm_unlink(name.c_str());
+    }
+
+    //==============================================================================
+    int ShmRing::NumSlots() const {
+        return int(header()->numSlots);
+    }
+
+    //==============================================================================
+    uint64 ShmRing::SlotBytes() const {
+        return header()->slotBytes;
+    }
+
+    //==============================================================================
+    ShmMessage *ShmRing::messages() const {
+        return reinterpret_cast<ShmMessage *>(base + header()->messagesOffset);
+    }
+
+    //==============================================================================
+    std::atomic<uint32> *ShmRing::slotRefs() const {
+        return reinterpret_cast<std::atomic<uint32> *>(base + header()->refsOffset);
+    }
+
+    //==============================================================================
+    uint8 *ShmRing::slotData(int slot) const {
+        return base + header()->dataOffset + uint64(slot) * header()->slotBytes;
+    }
+
+    //==============================================================================
+    int ShmRing::slotOf(const uint8 *pixels) const {
+        const uint8 *data = base + header()->dataOffset;
+        if (pixels < data || pixels >= base + size)
+            return -1;
+        uint64 offset = uint64(pixels - data);
+        if (offset % header()->slotBytes != 0)
+            return -1;
+        return int(offset / header()->slotBytes);
+    }
+
+    //==============================================================================
+    int ShmRing::acquireSlot(int timeoutMs) {
+        Header *h = header();
+        int n = int(h->numSlots);
+        int found = -1;
+        auto tryAcquire = [this, h, n, &found] {
+            if (h->consumerClosed.load(std::memory_order_acquire))
+                return true;
+            for (int k = 0; k < n; ++k) {
+                int s = (nextSlot + k) % n;
+                uint32 zero = 0;
+                if (slotRefs()[s].compare_exchange_strong(zero, 1, std::memory_order_acq_rel)) {
+                    found = s;
+                    nextSlot = (s + 1) % n;
+                    return true;
+                }
+            }
+            return false;
+        };
+        waitFor(&h->consumerEvents, tryAcquire, timeoutMs);
+        return found;
+    }
+
+    //==============================================================================
+    void ShmRing::releaseSlot(int slot) {
+        if (slotRefs()[slot].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            wake(&header()->consumerEvents);
+    }
+
+    //==============================================================================
+    bool ShmRing::push(const ShmMessage &msg, int timeoutMs) {
+        Header *h = header();
+        uint64 head = h->head.load(std::memory_order_relaxed);
+        bool hasSpace = waitFor(&h->consumerEvents, [h, head] {
+            return h->consumerClosed.load(std::memory_order_acquire) ||
+                   head - h->tail.load(std::memory_order_acquire) < h->numMessages;
+        }, timeoutMs);
+        if (!hasSpace || h->consumerClosed.load(std::memory_order_acquire))
+            return false;
+        messages()[head % h->numMessages] = msg;
+        h->head.store(head + 1, std::memory_order_release);
+        wake(&h->producerEvents);
+        return true;
+    }
+
+    //==============================================================================
+    std::unique_ptr<ImageFrame> ShmRing::NewFrame(ImageFormat::Format format, int width, int height, int timeoutMs) {
+        int rowBytes = width * ImageFrame::NumberOfChannelsForFormat(format) * ImageFrame::ByteDepthForFormat(format);
+        int widthStep = int(roundUp(rowBytes, ImageFrame::kDefaultAlignmentBoundary));
+        if (uint64(widthStep) * height > SlotBytes())
+            return nullptr;
+        int slot = acquireSlot(timeoutMs);
+        if (slot < 0)
+            return nullptr;
+        std::shared_ptr<ShmRing> self = shared_from_this();
+        return std::unique_ptr<ImageFrame>(new ImageFrame(
+                format, width, height, widthStep, slotData(slot),
+                [self, slot](uint8 *) { self->releaseSlot(slot); }));
+    }
+
+    //==============================================================================
+    bool ShmRing::SendFrame(const ImageFrame &frame, Timestamp ts, int timeoutMs, bool *copied) {
+        const ImageFrame *src = &frame;
+        std::unique_ptr<ImageFrame> copy;
+        int slot = slotOf(frame.PixelData());
+        *copied = slot < 0;
+        if (slot < 0) {
+            // Not our frame: one copy into a slot
+            copy = NewFrame(frame.Format(), frame.Width(), frame.Height(), timeoutMs);
+            if (!copy)
+                return false;
+            int rowBytes = frame.Width() * frame.NumberOfChannels() * frame.ByteDepth();
+            for (int y = 0; y < frame.Height(); ++y)
+                std::memcpy(copy->MutablePixelData() + y * copy->WidthStep(),
+                            frame.PixelData() + y * frame.WidthStep(), rowBytes);
+            src = copy.get();
+            slot = slotOf(src->PixelData());
+        }
+        // The consumer's reference, dropped by its FrameOf() frame
+        slotRefs()[slot].fetch_add(1, std::memory_order_acq_rel);
+        ShmMessage msg{ShmMessageKind::PACKET, slot, ts.Value(), NowUs(),
+                       int32(src->Format()), src->Width(), src->Height(), src->WidthStep()};
+        if (!push(msg, timeoutMs)) {
+            releaseSlot(slot);
+            return false;
+        }
+        return true;
+    }
+
+    //==============================================================================
+    bool ShmRing::SendBound(Timestamp bound, int timeoutMs) {
+        ShmMessage msg{ShmMessageKind::BOUND, -1, bound.Value(), NowUs(), 0, 0, 0, 0};
+        return push(msg, timeoutMs);
+    }
+
+    //==============================================================================
+    bool ShmRing::SendClose(int timeoutMs) {
+        header()->producerClosed.store(1, std::memory_order_release);
+        ShmMessage msg{ShmMessageKind::CLOSE, -1, 0, NowUs(), 0, 0, 0, 0};
+        return push(msg, timeoutMs);
+    }
+
+    //==============================================================================
+    bool ShmRing::ConsumerClosed() const {
+        return header()->consumerClosed.load(std::memory_order_acquire) != 0;
+    }
+
+    //==============================================================================
+    void ShmRing::CloseConsumer() {
+        header()->consumerClosed.store(1, std::memory_order_release);
+        // A producer waiting for space gives up at once
+        wake(&header()->consumerEvents);
+    }
+
+    //==============================================================================
+    bool ShmRing::ProducerClosed() const {
+        return header()->producerClosed.load(std::memory_order_acquire) != 0;
+    }
+
+    //==============================================================================
+    bool ShmRing::Receive(ShmMessage *msg, int timeoutMs) {
+        Header *h = header();
+        uint64 tail = h->tail.load(std::memory_order_relaxed);
+        bool hasMessage = waitFor(&h->producerEvents, [h, tail] {
+            return h->head.load(std::memory_order_acquire) != tail;
+        }, timeoutMs);
+        if (!hasMessage)
+            return false;
+        *msg = messages()[tail % h->numMessages];
+        h->tail.store(tail + 1, std::memory_order_release);
+        wake(&h->consumerEvents);
+        return true;
+    }
+
+    //==============================================================================
+    std::unique_ptr<ImageFrame> ShmRing::FrameOf(const ShmMessage &msg) {
+        if (msg.kind != ShmMessageKind::PACKET || msg.slot < 0 || msg.slot >= NumSlots())
+            return nullptr;
+        // The message comes from another process: check it fully before ImageFrame trusts it
+        // All sizes in uint64, positive int32 products cannot overflow there
+        int bpp = pixelBytes(msg.format);
+        if (bpp == 0 || msg.width <= 0 || msg.height <= 0 || msg.widthStep <= 0 ||
+            uint64(msg.widthStep) < uint64(msg.width) * bpp ||
+            uint64(msg.widthStep) * uint64(msg.height) > SlotBytes()) {
+            releaseSlot(msg.slot);  // Our reference, nobody else will drop it
+            return nullptr;
+        }
+        std::shared_ptr<ShmRing> self = shared_from_this();
+        int slot = msg.slot;
+        return std::unique_ptr<ImageFrame>(new ImageFrame(
+                ImageFormat::Format(msg.format), msg.width, msg.height, msg.widthStep, slotData(slot),
+                [self, slot](uint8 *) { self->releaseSlot(slot); }));
+    }
+}
+//==============================================================================
@@ -0,0 +1,138 @@
+#pragma once
+// A shared-memory ring which moves ImageFrame packets between processes, pixels by slot handle
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/timestamp.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Message kinds
+    enum class ShmMessageKind : uint32 {
+        PACKET = 1,   /// A frame in a slot at timestamp
+        BOUND = 2,    /// A timestamp bound without a packet, timestamp = the next allowed timestamp
+        CLOSE = 3     /// The producer has finished
+    };
+
+    /// A message in the ring, small and fixed-size: pixels never go through the message queue
+    struct ShmMessage {
+        ShmMessageKind kind;
+        int32 slot;           /// PACKET: the slot with the pixels
+        int64 timestamp;      /// Timestamp::Value(), special values included
+        int64 sendUs;         /// NowUs() of the producer when sent, to measure the transport latency
+        int32 format, width, height, widthStep;
+    };
+
+    /// Single producer process, single consumer process, over a POSIX shared memory object (/dev/shm/<name>)
+    /// The memory has numSlots pixel slots of slotBytes each and a queue of numMessages ShmMessage
+    /// Zero copy: the producer can allocate its frames right in the slots (NewFrame()), and the consumer
+    /// gets ImageFrame views of the slots (FrameOf()); only the message (slot handle + timestamp) is queued
+    /// Frames from elsewhere are copied to a slot once by SendFrame()
+    /// Each slot has a reference count shared by both processes: a slot is free again when
+    /// the producer and the consumer have both destroyed their ImageFrame
+    /// All waits are futexes in the shared memory, with timeouts: if the other process dies,
+    /// we do not hang, the producer drops frames and the consumer sees no messages
+    /// Thread-safe only as SPSC: one thread sends, one thread receives (frame deleters can run anywhere)
+    class ShmRing : public std::enable_shared_from_this<ShmRing> {
+    public:
+        /// Producer: create the shared memory object (replacing an old one), nullptr on failure
+        static std::shared_ptr<ShmRing> Create(const std::string &name, int numSlots, uint64 slotBytes,
+                                               int numMessages = 64);
+
+        /// Consumer: open the object made by Create(), waits up to timeoutMs for the producer, nullptr on failure
+        /// A leftover of a crashed producer (its process is gone) is skipped
+        static std::shared_ptr<ShmRing> Open(const std::string &name, int timeoutMs);
+
+        /// Unmap, the producer also removes the name (the memory lives until both processes unmap it)
+        ~ShmRing();
+
+        //==============================================================================
+        // Producer side
+
+        /// A frame with the pixels in a free slot, waits up to timeoutMs for one, nullptr if none
+        /// or if the frame is bigger than slotBytes
+        std::unique_ptr<ImageFrame> NewFrame(ImageFormat::Format format, int width, int height, int timeoutMs);
+
+        /// Send a frame at ts: by slot handle if it comes from NewFrame() of this ring,
+        /// otherwise it is copied to a free slot first (*copied = true)
+        /// Waits up to timeoutMs for a free slot and queue space, false = dropped
+        bool SendFrame(const ImageFrame &frame, Timestamp ts, int timeoutMs, bool *copied);
+
+        /// Send a timestamp bound (the next allowed timestamp), false = dropped
+        bool SendBound(Timestamp bound, int timeoutMs);
+
+        /// Tell the consumer we have finished (ProducerClosed() is true even if the message is dropped)
+        bool SendClose(int timeoutMs);
+
+        /// The consumer has called CloseConsumer(), all sends fail from now on
+        bool ConsumerClosed() const;
+
+        //==============================================================================
+        // Consumer side
+
+        /// Wait up to timeoutMs for the next message, false on timeout
+        bool Receive(ShmMessage *msg, int timeoutMs);
+
+        /// Zero-copy ImageFrame over the slot of a PACKET message, it releases the slot when destroyed
+        /// Call it exactly once for each PACKET message; nullptr (slot released) if the message is invalid
+        std::unique_ptr<ImageFrame> FrameOf(const ShmMessage &msg);
+
+        /// Tell the producer we do not want more messages
+        void CloseConsumer();
+
+        /// The producer has called SendClose(), the remaining messages can still be received
+        bool ProducerClosed() const;
+
+        //==============================================================================
+        /// Monotonic clock in microseconds, the same in all processes (and the same as CaptureThread::NowUs())
+        static int64 NowUs() {
+            using namespace std::chrono;
+            return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        int NumSlots() const;
+
+        uint64 SlotBytes() const;
+
+    private:
+        struct Header;
+
+        ShmRing(const std::string &name, bool owner, uint8 *base, uint64 size) :
+                name(name), owner(owner), base(base), size(size) {}
+
+        Header *header() const { return reinterpret_cast<Header *>(base); }
+
+        /// The regions described by a header (written by another process) all lie within size bytes
+        static bool layoutFits(const Header *h, uint64 size);
+
+        ShmMessage *messages() const;
+
+        std::atomic<uint32> *slotRefs() const;
+
+        uint8 *slotData(int slot) const;
+
+        /// Slot index of pixels, -1 if they are not at the start of a slot
+        int slotOf(const uint8 *pixels) const;
+
+        /// Take a free slot (refs 0 -> 1), -1 on timeout
+        int acquireSlot(int timeoutMs);
+
+        /// Drop one reference, wakes the producer if the slot is free
+        void releaseSlot(int slot);
+
+        /// Put a message in the queue, false on timeout
+        bool push(const ShmMessage &msg, int timeoutMs);
+
+        std::string name;
+        bool owner;
+        uint8 *base;
+        uint64 size;
+        int nextSlot = 0;
+    };
+}
+//==============================================================================
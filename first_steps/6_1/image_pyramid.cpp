@@ -0,0 +1,77 @@
+#include <cmath>
+#include <cstdlib>
+
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/6_1/image_pyramid.h"
+
+//==============================================================================
+namespace mediapipe {
+    Status ImagePyramid::Build(const Packet &base, int numLevels, double scaleFactor, int minSize) {
+        using namespace std;
+        const ImageFrame &frame = base.Get<ImageFrame>();
+        if (frame.ByteDepth() != 1)
+            return absl::InvalidArgumentError("ImagePyramid : only 8 bit per channel images are supported !");
+        if (numLevels < 1 || scaleFactor <= 1.0)
+            return absl::InvalidArgumentError("ImagePyramid : bad numLevels or scaleFactor !");
+        this->base = base;
+        this->scaleFactor = scaleFactor;
+        format = frame.Format();
+        levels.clear();
+        levelScales.clear();
+        // Level 0 is a view of the original frame
+        levels.push_back(formats::MatView(&frame));
+        levelScales.push_back(1.0);
+
+        // Level sizes (the same rounding as cv::ORB), rows are aligned like in ImageFrame
+        const int align = ImageFrame::kDefaultAlignmentBoundary;
+        const int pixelBytes = frame.NumberOfChannels();
+        vector<cv::Size> sizes;
+        vector<size_t> offsets, steps;
+        size_t total = 0;
+        for (int i = 1; i < numLevels; ++i) {
+            double scale = 1.0 / pow(scaleFactor, i);
+            cv::Size sz(cvRound(frame.Width() * scale), cvRound(frame.Height() * scale));
+            if (sz.width < minSize || sz.height < minSize)
+                break;
+            size_t step = (size_t(sz.width) * pixelBytes + align - 1) / align * align;
+            sizes.push_back(sz);
+            offsets.push_back(total);
+            steps.push_back(step);
+            levelScales.push_back(scale);
+            total += step * sz.height;
+        }
+        if (sizes.empty()) {
+            storage.reset();
+            return OkStatus();
+        }
+
+        // One buffer for all levels, cache line aligned
+        total = (total + 63) / 64 * 64;
+        storage.reset(static_cast<uint8 *>(aligned_alloc(64, total)), free);
+        if (!storage)
+            return absl::ResourceExhaustedError("ImagePyramid : cannot allocate memory !");
+        int type = levels[0].type();
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            cv::Mat level(sizes[i], type, storage.get() + offsets[i], steps[i]);
+            // Each level is resampled from the previous one, as cv::ORB does
+            // The size and type match, so cv::resize() writes into our buffer
+            cv::resize(levels.back(), level, sizes[i], 0, 0, cv::INTER_LINEAR);
+            levels.push_back(level);
+        }
+        return OkStatus();
+    }
+
+    //==============================================================================
+    std::unique_ptr<ImageFrame> ImagePyramid::LevelFrame(int i) const {
+        const cv::Mat &m = levels[i];
+        // The deleter keeps the original packet and the storage alive, and deletes nothing
+        Packet keepBase = base;
+        std::shared_ptr<uint8> keepStorage = storage;
+        return std::unique_ptr<ImageFrame>(new ImageFrame(
+                format, m.cols, m.rows, m.step, m.data,
+                [keepBase, keepStorage](uint8 *) {}));
+    }
+}
+//==============================================================================
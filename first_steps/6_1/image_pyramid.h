@@ -0,0 +1,52 @@
+#pragma once
+// An image pyramid which is built once and shared by several calculators
+
+#include <memory>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// A multi-level image pyramid, the packet type of the PYRAMID streams
+    /// Level 0 is the original ImageFrame (not copied, we keep its packet)
+    /// Level i has the size of level 0 times LevelScale(i) = 1 / scaleFactor^i
+    /// All levels 1, 2, ... live in ONE memory buffer, shared by all copies of the pyramid,
+    /// so copying ImagePyramid (or a packet with it) never copies pixels
+    /// The pixels are read-only once the pyramid is built, as usual for packet data
+    class ImagePyramid {
+    public:
+        /// Build the pyramid from an ImageFrame packet (8 bit per channel formats only)
+        /// Levels smaller than minSize pixels (in width or height) are not created
+        Status Build(const Packet &base, int numLevels, double scaleFactor, int minSize);
+
+        int NumLevels() const { return levels.size(); }
+
+        double ScaleFactor() const { return scaleFactor; }
+
+        /// Level size / level 0 size
+        double LevelScale(int i) const { return levelScales[i]; }
+
+        ImageFormat::Format Format() const { return format; }
+
+        /// Level i as cv::Mat, no copying, do NOT modify it
+        const cv::Mat &Level(int i) const { return levels[i]; }
+
+        /// Level i as ImageFrame, no copying: the ImageFrame keeps the pyramid storage alive
+        std::unique_ptr<ImageFrame> LevelFrame(int i) const;
+
+    private:
+        Packet base;
+        std::shared_ptr<uint8> storage;
+        std::vector<cv::Mat> levels;
+        std::vector<double> levelScales;
+        double scaleFactor = 1.0;
+        ImageFormat::Format format = ImageFormat::UNKNOWN;
+    };
+}
+//==============================================================================
@@ -0,0 +1,42 @@
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/6_1/image_pyramid.h"
+#include "mediapipe/examples/first_steps/6_1/image_pyramid_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Builds an ImagePyramid from each input frame
+    /// All calculators which need a downscaled image take it from the PYRAMID stream,
+    /// so that each level is computed once per frame
+    class ImagePyramidCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            cc->Outputs().Tag("PYRAMID").Set<ImagePyramid>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<ImagePyramidCalculatorOptions>();
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            ImagePyramid *pyramid = new ImagePyramid();
+            Status status = pyramid->Build(cc->Inputs().Tag("IMAGE").Value(), options.num_levels(),
+                                           options.scale_factor(), options.min_size());
+            if (!status.ok()) {
+                delete pyramid;
+                return status;
+            }
+            cc->Outputs().Tag("PYRAMID").Add(pyramid, cc->InputTimestamp());
+            return OkStatus();
+        }
+    private:
+        ImagePyramidCalculatorOptions options;
+    };
+    REGISTER_CALCULATOR(ImagePyramidCalculator);
+}
+//==============================================================================
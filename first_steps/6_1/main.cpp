@@ -0,0 +1,240 @@
+/// Example 6.1 : Shared image pyramid
+/// By Oleksiy Grechnyev, IT-JIM
+/// In example 2.4 FeatureDetectorCalculator (ORB) builds its own scale pyramid from the full frame,
+/// and if we also need a downscaled frame (ScaleImageCalculator of 2.2), it is resampled again
+/// Here ImagePyramidCalculator builds the pyramid ONCE per frame and sends it as one packet (PYRAMID),
+/// and two pyramid-aware calculators use it:
+/// PyramidScaleCalculator : downscales starting from the suitable pyramid level
+/// PyramidFeatureDetectorCalculator : ORB on each pyramid level
+/// Usage:
+/// 6_1 : camera demo
+/// 6_1 bench : compare the standard calculators and the pyramid ones on synthetic 1280x720 frames
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+//==============================================================================
+/// Standard calculators: ORB and the scaler both resample the full frame
+static const char *PROTO_STANDARD = R"(
+    input_stream: "in"
+    output_stream: "feat"
+    output_stream: "small"
+    node {
+        calculator: "FeatureDetectorCalculator"
+        input_stream: "IMAGE:in"
+        output_stream: "FEATURES:feat"
+        options : {
+            [mediapipe.FeatureDetectorCalculatorOptions.ext] {
+                max_features : 1000
+            }
+        }
+    }
+    node {
+        calculator: "ScaleImageCalculator"
+        input_stream: "in"
+        output_stream: "small"
+        options: {
+            [mediapipe.ScaleImageCalculatorOptions.ext] {
+                target_width: 640
+                target_height: 360
+                preserve_aspect_ratio: false
+                algorithm: AREA
+            }
+        }
+    }
+    )";
+
+/// The same with the shared pyramid (4 levels, scale 1.2 like FeatureDetectorCalculator)
+static const char *PROTO_PYRAMID = R"(
+    input_stream: "in"
+    output_stream: "feat"
+    output_stream: "small"
+    node {
+        calculator: "ImagePyramidCalculator"
+        input_stream: "IMAGE:in"
+        output_stream: "PYRAMID:pyr"
+        options : {
+            [mediapipe.ImagePyramidCalculatorOptions.ext] {
+                num_levels : 4
+                scale_factor : 1.2
+            }
+        }
+    }
+    node {
+        calculator: "PyramidFeatureDetectorCalculator"
+        input_stream: "PYRAMID:pyr"
+        output_stream: "FEATURES:feat"
+        options : {
+            [mediapipe.PyramidFeatureDetectorCalculatorOptions.ext] {
+                max_features : 1000
+            }
+        }
+    }
+    node {
+        calculator: "PyramidScaleCalculator"
+        input_stream: "PYRAMID:pyr"
+        output_stream: "IMAGE:small"
+        options: {
+            [mediapipe.PyramidScaleCalculatorOptions.ext] {
+                target_width: 640
+                target_height: 360
+            }
+        }
+    }
+    )";
+
+//==============================================================================
+/// Send numFrames synthetic frames through a graph, print the time per frame
+mediapipe::Status runBench(const std::string &name, const std::string &protoG, int numFrames) {
+    using namespace std;
+    using namespace mediapipe;
+
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+    atomic_int numFeat(0);
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("feat", [&numFeat](const Packet &packet)->Status{
+        numFeat += packet.Get<vector<cv::KeyPoint>>().size();
+        return OkStatus();
+    }));
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("small", [](const Packet &packet)->Status{
+        return OkStatus();
+    }));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // A smooth random image, so that ORB finds some corners
+    cv::Mat noise(90, 160, CV_8UC3), img;
+    cv::randu(noise, 0, 256);
+    cv::resize(noise, img, cv::Size(1280, 720), 0, 0, cv::INTER_CUBIC);
+
+    auto t1 = chrono::steady_clock::now();
+    for (int i = 0; i < numFrames; ++i) {
+        ImageFrame *inputFrame =  new ImageFrame(
+            ImageFormat::SRGB, img.cols, img.rows, ImageFrame::kDefaultAlignmentBoundary
+        );
+        img.copyTo(formats::MatView(inputFrame));
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", Adopt(inputFrame).At(Timestamp(i))));
+    }
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    auto t2 = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(t2 - t1).count() / numFrames;
+    cout << name << " : " << ms << " ms/frame, " << numFeat / numFrames << " keypoints/frame" << endl;
+    return OkStatus();
+}
+
+//==============================================================================
+/// Camera demo: draw the keypoints on the full frame, show the small frame too
+mediapipe::Status runCamera() {
+    using namespace std;
+    using namespace mediapipe;
+
+    string protoG = string(PROTO_PYRAMID) + R"(
+        output_stream: "out"
+        node {
+            calculator: "DrawFeatCalculator24"
+            input_stream: "IMAGE:in"
+            input_stream: "FEATURES:feat"
+            output_stream: "IMAGE:out"
+        }
+        )";
+
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    // Mutex protecting imshow() and the stop flag
+    mutex mutexImshow;
+    atomic_bool flagStop(false);
+
+    // One callback for both "out" and "small", the window name is the stream name
+    auto makeCb = [&mutexImshow, &flagStop](const string &winName) {
+        return [&mutexImshow, &flagStop, winName](const Packet &packet)->Status{
+            const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+            cv::Mat ofMat = formats::MatView(&outputFrame);
+            cv::Mat frameOut;
+            cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+            lock_guard<mutex> lock(mutexImshow);
+            cv::imshow(winName, frameOut);
+            if (27 == cv::waitKey(1)){
+                cout << "It's time to QUIT !" << endl;
+                flagStop = true;
+            }
+            return OkStatus();
+        };
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", makeCb("out")));
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("small", makeCb("small")));
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("feat", [](const Packet &packet)->Status{
+        cout << packet.Timestamp() << ": KEYPOINTS = " << packet.Get<vector<cv::KeyPoint>>().size() << endl;
+        return OkStatus();
+    }));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // Start the camera and check that it works
+    cv::VideoCapture cap(cv::CAP_ANY);
+    if (!cap.isOpened())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    cv::Mat frameIn, frameInRGB;
+
+    // Camera loop, runs until we get flagStop == true
+    for (int i=0; !flagStop ; ++i){
+        cap.read(frameIn);
+        if (frameIn.empty())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+        cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+        ImageFrame *inputFrame =  new ImageFrame(
+            ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary
+        );
+        frameInRGB.copyTo(formats::MatView(inputFrame));
+        Timestamp ts(i);
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in",
+            Adopt(inputFrame).At(ts)
+        ));
+    }
+    // Close the input streams, Wait for the graph to finish
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 6.1 : Shared image pyramid" << endl;
+    mediapipe::Status status;
+    if (argc > 1 && string(argv[1]) == "bench") {
+        status = runBench("STANDARD", PROTO_STANDARD, 200);
+        if (status.ok())
+            status = runBench("PYRAMID ", PROTO_PYRAMID, 200);
+    } else {
+        status = runCamera();
+    }
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_features2d_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/6_1/image_pyramid.h"
+#include "mediapipe/examples/first_steps/6_1/pyramid_feature_detector_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// A replacement of FeatureDetectorCalculator which takes a PYRAMID
+    /// FeatureDetectorCalculator gives the full-resolution frame to cv::ORB, which builds its own
+    /// scale pyramid internally. Here we run a single-level ORB on each pyramid level instead,
+    /// and map the keypoints back to level 0 coordinates, so no level is resampled twice
+    /// Keypoints are distributed over the levels like in cv::ORB (proportional to the level area)
+    /// Outputs: FEATURES (std::vector<cv::KeyPoint>), optional DESCRIPTORS (cv::Mat, one row per keypoint)
+    class PyramidFeatureDetectorCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("PYRAMID").Set<ImagePyramid>();
+            cc->Outputs().Tag("FEATURES").Set<std::vector<cv::KeyPoint>>();
+            if (cc->Outputs().HasTag("DESCRIPTORS"))
+                cc->Outputs().Tag("DESCRIPTORS").Set<cv::Mat>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<PyramidFeatureDetectorCalculatorOptions>();
+            withDescriptors = cc->Outputs().HasTag("DESCRIPTORS");
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            using namespace std;
+            const ImagePyramid &pyramid = cc->Inputs().Tag("PYRAMID").Get<ImagePyramid>();
+            int n = pyramid.NumLevels();
+            if (n != int(orbs.size()) || pyramid.ScaleFactor() != scaleFactor)
+                createDetectors(n, pyramid.ScaleFactor());
+
+            vector<cv::KeyPoint> *allKps = new vector<cv::KeyPoint>();
+            cv::Mat allDesc;
+            vector<cv::KeyPoint> kps;
+            cv::Mat desc;
+            for (int i = 0; i < n; ++i) {
+                const cv::Mat &level = pyramid.Level(i);
+                if (level.channels() == 1)
+                    gray = level;
+                else
+                    cv::cvtColor(level, gray, level.channels() == 4 ? cv::COLOR_RGBA2GRAY : cv::COLOR_RGB2GRAY);
+                kps.clear();
+                if (withDescriptors)
+                    orbs[i]->detectAndCompute(gray, cv::noArray(), kps, desc);
+                else
+                    orbs[i]->detect(gray, kps);
+
+                // From level i to level 0 coordinates, octave = level, as cv::ORB does
+                float s = 1.0f / pyramid.LevelScale(i);
+                for (cv::KeyPoint &kp : kps) {
+                    kp.pt *= s;
+                    kp.size *= s;
+                    kp.octave = i;
+                }
+                allKps->insert(allKps->end(), kps.begin(), kps.end());
+                if (withDescriptors && !desc.empty())
+                    allDesc.push_back(desc);
+            }
+            cc->Outputs().Tag("FEATURES").Add(allKps, cc->InputTimestamp());
+            if (withDescriptors)
+                cc->Outputs().Tag("DESCRIPTORS").AddPacket(MakePacket<cv::Mat>(allDesc).At(cc->InputTimestamp()));
+            return OkStatus();
+        }
+
+    private:
+        /// One single-level ORB per pyramid level, each with its share of max_features
+        void createDetectors(int n, double sf) {
+            scaleFactor = sf;
+            orbs.clear();
+            double factor = 1.0 / sf;
+            double perLevel = options.max_features() * (1 - factor) / (1 - std::pow(factor, n));
+            int sum = 0;
+            for (int i = 0; i < n; ++i) {
+                int nf = (i < n - 1) ? cvRound(perLevel) : std::max(options.max_features() - sum, 0);
+                sum += nf;
+                perLevel *= factor;
+                orbs.push_back(cv::ORB::create(nf, float(sf), 1, 31, 0, 2, cv::ORB::HARRIS_SCORE, 31,
+                                               options.fast_threshold()));
+            }
+        }
+
+        PyramidFeatureDetectorCalculatorOptions options;
+        bool withDescriptors = false;
+        double scaleFactor = 0;
+        std::vector<cv::Ptr<cv::ORB>> orbs;
+        cv::Mat gray;
+    };
+    REGISTER_CALCULATOR(PyramidFeatureDetectorCalculator);
+}
+//==============================================================================
@@ -0,0 +1,63 @@
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/6_1/image_pyramid.h"
+#include "mediapipe/examples/first_steps/6_1/pyramid_scale_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// A replacement of ScaleImageCalculator (downscaling only) which takes a PYRAMID
+    /// Instead of resampling the full-resolution frame, it starts from the smallest pyramid level
+    /// which is still not smaller than the target size, so only a small final resize is left
+    /// If a level has exactly the target size, it is sent without copying
+    class PyramidScaleCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("PYRAMID").Set<ImagePyramid>();
+            cc->Outputs().Tag("IMAGE").Set<ImageFrame>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            const auto &options = cc->Options<PyramidScaleCalculatorOptions>();
+            targetWidth = options.target_width();
+            targetHeight = options.target_height();
+            if (targetWidth <= 0 || targetHeight <= 0)
+                return absl::InvalidArgumentError("PyramidScaleCalculator : target size is not set !");
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            const ImagePyramid &pyramid = cc->Inputs().Tag("PYRAMID").Get<ImagePyramid>();
+            // Levels get smaller, so find the last one which is still large enough
+            int best = 0;
+            for (int i = 1; i < pyramid.NumLevels(); ++i) {
+                const cv::Mat &l = pyramid.Level(i);
+                if (l.cols < targetWidth || l.rows < targetHeight)
+                    break;
+                best = i;
+            }
+            const cv::Mat &src = pyramid.Level(best);
+            if (src.cols == targetWidth && src.rows == targetHeight) {
+                cc->Outputs().Tag("IMAGE").Add(pyramid.LevelFrame(best).release(), cc->InputTimestamp());
+                return OkStatus();
+            }
+            ImageFrame *oFrame = new ImageFrame(pyramid.Format(), targetWidth, targetHeight,
+                                                ImageFrame::kDefaultAlignmentBoundary);
+            cv::Mat dst = formats::MatView(oFrame);
+            // INTER_AREA for downscaling, INTER_LINEAR if the image is too small and we must upscale
+            int interp = (src.cols >= targetWidth && src.rows >= targetHeight) ? cv::INTER_AREA : cv::INTER_LINEAR;
+            cv::resize(src, dst, dst.size(), 0, 0, interp);
+            cc->Outputs().Tag("IMAGE").Add(oFrame, cc->InputTimestamp());
+            return OkStatus();
+        }
+    private:
+        int targetWidth = 0, targetHeight = 0;
+    };
+    REGISTER_CALCULATOR(PyramidScaleCalculator);
+}
+//==============================================================================
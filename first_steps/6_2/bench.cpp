@@ -0,0 +1,100 @@
+/// Example 6.2 (benchmark) : PixelOp kernels vs OpenCV
+/// By Oleksiy Grechnyev, IT-JIM
+/// Each op is applied in place to an RGB frame (720p and 4K), to the whole frame and to the central 1/9,
+/// with OpenCV and with our SCALAR, SSE and AVX2 kernels
+/// No MediaPipe graph here, only the kernels
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/6_2/pixel_op.h"
+
+//==============================================================================
+/// Run f() numIter times on a fresh copy of img, return ms per call
+static double timeIt(const cv::Mat &img, int numIter, const std::function<void(cv::Mat &)> &f) {
+    using namespace std;
+    cv::Mat work = img.clone();
+    f(work);  // Warm-up
+    auto t1 = chrono::steady_clock::now();
+    for (int i = 0; i < numIter; ++i)
+        f(work);
+    auto t2 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t2 - t1).count() / numIter;
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+    using namespace mediapipe;
+
+    cout << "Example 6.2 (benchmark) : PixelOp kernels vs OpenCV" << endl;
+    cout << "Best SIMD on this CPU = " << SimdLevelName(DetectSimdLevel()) << endl;
+
+    // The same parameters for OpenCV and PixelOp
+    const double gain = 1.8, gamma = 0.5;
+    const int offset = -40, thresh = 100;
+    array<uint8, 256> table;
+    for (int i = 0; i < 256; ++i)
+        table[i] = uint8(lround(255 * pow(i / 255.0, gamma)));
+    cv::Mat cvTable(1, 256, CV_8U, table.data());
+
+    struct Op {
+        string name;
+        PixelOp op;
+        function<void(cv::Mat &)> cvOp;
+    };
+    vector<Op> ops = {
+        {"INVERT", PixelOp::Invert(), [](cv::Mat &m) { cv::bitwise_not(m, m); }},
+        {"GAIN", PixelOp::Gain(gain, offset), [&](cv::Mat &m) { m.convertTo(m, -1, gain, offset); }},
+        {"THRESHOLD", PixelOp::Threshold(thresh, 255),
+                [&](cv::Mat &m) { cv::threshold(m, m, thresh, 255, cv::THRESH_BINARY); }},
+        {"GAMMA", PixelOp::Lut(table), [&](cv::Mat &m) { cv::LUT(m, cvTable, m); }},
+    };
+    vector<SimdLevel> levels = {SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2};
+
+    struct Res {
+        string name;
+        cv::Size size;
+        int numIter;
+    };
+    for (const Res &res : {Res{"720p", cv::Size(1280, 720), 300}, Res{"4K", cv::Size(3840, 2160), 50}}) {
+        cv::Mat img(res.size, CV_8UC3);
+        cv::randu(img, 0, 256);
+        for (bool full : {true, false}) {
+            // The ROI: the whole frame or the central 1/9 (as in SlowCalculator)
+            cv::Rect roi = full ? cv::Rect(0, 0, img.cols, img.rows) :
+                           cv::Rect(img.cols / 3, img.rows / 3, img.cols / 3, img.rows / 3);
+            double mb = roi.area() * 3 / 1e6;
+            cout << endl << res.name << (full ? " FULL FRAME" : " CENTRAL 1/9") << " (" << mb << " MB)" << endl;
+            cout << setw(12) << "op" << setw(12) << "OpenCV";
+            for (SimdLevel l : levels)
+                cout << setw(12) << SimdLevelName(l);
+            cout << "   (ms, lower is better)" << endl;
+            for (const Op &op : ops) {
+                cout << setw(12) << op.name << setw(12) << setprecision(3)
+                     << timeIt(img, res.numIter, [&](cv::Mat &m) {
+                            cv::Mat r(m, roi);
+                            op.cvOp(r);
+                        });
+                for (SimdLevel l : levels) {
+                    double ms = timeIt(img, res.numIter, [&](cv::Mat &m) {
+                        uint8 *p = m.ptr(roi.y) + roi.x * 3;
+                        op.op.ApplyRect(p, m.step, p, m.step, roi.width * 3, roi.height, l);
+                    });
+                    cout << setw(12) << setprecision(3) << ms;
+                }
+                cout << endl;
+            }
+        }
+    }
+    return 0;
+}
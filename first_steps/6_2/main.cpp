@@ -0,0 +1,136 @@
+/// Example 6.2 : ROI pixel operations with SIMD
+/// By Oleksiy Grechnyev, IT-JIM
+/// SlowCalculator (3.1) applies a photo negative to the central 1/9 of the frame with cv::bitwise_not()
+/// after copying the whole frame. RoiPixelOpCalculator is the general version:
+/// invert, gain, threshold or gamma (LUT) with AVX2/SSE/scalar kernels (pixel_op.h),
+/// the ROI comes from the options or from a Rect stream,
+/// and the frame is modified in place if nobody else holds the packet
+/// Here the ROI moves around the frame, sent on the "rect" stream
+/// Usage: 6_2 [INVERT|GAIN|THRESHOLD|GAMMA]
+/// See also 6_2_bench, which compares the kernels with OpenCV
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <cmath>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+//==============================================================================
+mediapipe::Status run(const std::string &opName) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // Note: "in" goes ONLY to RoiPixelOpCalculator, so it can modify the frame in place
+    // If we observed "in" too, the packet would be shared, and the calculator would copy it
+    string protoG = R"(
+        input_stream: "in"
+        input_stream: "rect"
+        output_stream: "out"
+        node {
+            calculator: "RoiPixelOpCalculator"
+            input_stream: "IMAGE:in"
+            input_stream: "RECT:rect"
+            output_stream: "IMAGE:out"
+            options: {
+                [mediapipe.RoiPixelOpCalculatorOptions.ext] {
+                    op: )" + opName + R"(
+                    gain: 1.8
+                    offset: -40
+                    threshold: 100
+                    gamma: 0.5
+                }
+            }
+        }
+        )";
+
+    // Parse config and create graph
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    atomic_bool flagStop(false);
+
+    // Add observer to "out", then start the graph
+    auto cb = [&flagStop](const Packet &packet)->Status{
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        cv::imshow("frameOut", frameOut);
+        if (27 == cv::waitKey(1)){
+            cout << "It's time to QUIT !" << endl;
+            flagStop = true;
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // Start the camera and check that it works
+    cv::VideoCapture cap(cv::CAP_ANY);
+    if (!cap.isOpened())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    cv::Mat frameIn, frameInRGB;
+
+    // Camera loop, runs until we get flagStop == true
+    for (int i=0; !flagStop ; ++i){
+        cap.read(frameIn);
+        if (frameIn.empty())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+        cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+        ImageFrame *inputFrame =  new ImageFrame(
+            ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary
+        );
+        frameInRGB.copyTo(formats::MatView(inputFrame));
+        Timestamp ts(i);
+
+        // The ROI (1/3 of the frame size) moves along a circle
+        int w = frameInRGB.cols, h = frameInRGB.rows;
+        Rect rect;
+        rect.set_x_center(int(w / 2 + w / 4 * cos(i * 0.05)));
+        rect.set_y_center(int(h / 2 + h / 4 * sin(i * 0.05)));
+        rect.set_width(w / 3);
+        rect.set_height(h / 3);
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("rect", MakePacket<Rect>(rect).At(ts)));
+
+        // The packet is moved into the graph (Packet &&), so we do not keep a reference to it
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in",
+            Adopt(inputFrame).At(ts)
+        ));
+    }
+    // Close the input streams, Wait for the graph to finish
+    graph.CloseInputStream("in");
+    graph.CloseInputStream("rect");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 6.2 : ROI pixel operations with SIMD" << endl;
+    string opName = argc > 1 ? argv[1] : "INVERT";
+    mediapipe::Status status = run(opName);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PIXEL_OP_X86
+#include <immintrin.h>
+#endif
+
+#include "mediapipe/examples/first_steps/6_2/pixel_op.h"
+
+//==============================================================================
+namespace mediapipe {
+    namespace {
+        // The kernels process the head of the row with SIMD and return the number of bytes done,
+        // the tail is always done by the scalar kernel
+
+        //==============================================================================
+        void scalarRow(PixelOp::Kind kind, uint8 *dst, const uint8 *src, int64 n,
+                       uint16 gain256, int16 offset, uint8 thresh, uint8 maxValue, const uint8 *table) {
+            switch (kind) {
+                case PixelOp::INVERT:
+                    for (int64 i = 0; i < n; ++i)
+                        dst[i] = ~src[i];
+                    break;
+                case PixelOp::GAIN:
+                    for (int64 i = 0; i < n; ++i) {
+                        // The same rounding as _mm_mulhi_epu16(src << 8, gain256)
+                        int v = (uint32(src[i]) * 256 * gain256) >> 16;
+                        dst[i] = uint8(std::min(std::max(v + offset, 0), 255));
+                    }
+                    break;
+                case PixelOp::THRESHOLD:
+                    for (int64 i = 0; i < n; ++i)
+                        dst[i] = src[i] > thresh ? maxValue : 0;
+                    break;
+                case PixelOp::LUT: {
+                    // Unrolled, so that the 4 loads are independent
+                    int64 i = 0;
+                    for (; i + 4 <= n; i += 4) {
+                        uint8 a = table[src[i]], b = table[src[i + 1]], c = table[src[i + 2]], d = table[src[i + 3]];
+                        dst[i] = a;
+                        dst[i + 1] = b;
+                        dst[i + 2] = c;
+                        dst[i + 3] = d;
+                    }
+                    for (; i < n; ++i)
+                        dst[i] = table[src[i]];
+                    break;
+                }
+            }
+        }
+
+#ifdef PIXEL_OP_X86
+        //==============================================================================
+        int64 sseRow(PixelOp::Kind kind, uint8 *dst, const uint8 *src, int64 n,
+                     uint16 gain256, int16 offset, uint8 thresh, uint8 maxValue) {
+            int64 i = 0;
+            const __m128i zero = _mm_setzero_si128();
+            switch (kind) {
+                case PixelOp::INVERT: {
+                    const __m128i ones = _mm_set1_epi8(-1);
+                    for (; i + 16 <= n; i += 16) {
+                        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_xor_si128(x, ones));
+                    }
+                    break;
+                }
+                case PixelOp::GAIN: {
+                    const __m128i g = _mm_set1_epi16(int16(gain256));
+                    const __m128i o = _mm_set1_epi16(offset);
+                    for (; i + 16 <= n; i += 16) {
+                        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                        // unpack(zero, x) gives x << 8 in each 16-bit lane
+                        __m128i lo = _mm_mulhi_epu16(_mm_unpacklo_epi8(zero, x), g);
+                        __m128i hi = _mm_mulhi_epu16(_mm_unpackhi_epi8(zero, x), g);
+                        lo = _mm_adds_epi16(lo, o);
+                        hi = _mm_adds_epi16(hi, o);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+                    }
+                    break;
+                }
+                case PixelOp::THRESHOLD: {
+                    if (thresh == 255)
+                        break;  // Never true, the scalar kernel writes zeros
+                    // x > t  <=>  max(x, t + 1) == x
+                    const __m128i t1 = _mm_set1_epi8(char(thresh + 1));
+                    const __m128i m = _mm_set1_epi8(char(maxValue));
+                    for (; i + 16 <= n; i += 16) {
+                        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                        __m128i mask = _mm_cmpeq_epi8(_mm_max_epu8(x, t1), x);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_and_si128(mask, m));
+                    }
+                    break;
+                }
+                case PixelOp::LUT:
+                    break;
+            }
+            return i;
+        }
+
+        //==============================================================================
+        // Compiled for AVX2 regardless of the compiler flags, called only if the CPU has AVX2
+        __attribute__((target("avx2")))
+        int64 avx2Row(PixelOp::Kind kind, uint8 *dst, const uint8 *src, int64 n,
+                      uint16 gain256, int16 offset, uint8 thresh, uint8 maxValue) {
+            int64 i = 0;
+            const __m256i zero = _mm256_setzero_si256();
+            switch (kind) {
+                case PixelOp::INVERT: {
+                    const __m256i ones = _mm256_set1_epi8(-1);
+                    for (; i + 32 <= n; i += 32) {
+                        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_xor_si256(x, ones));
+                    }
+                    break;
+                }
+                case PixelOp::GAIN: {
+                    const __m256i g = _mm256_set1_epi16(int16(gain256));
+                    const __m256i o = _mm256_set1_epi16(offset);
+                    for (; i + 32 <= n; i += 32) {
+                        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                        // unpack and pack both work within 128-bit lanes, so the byte order is preserved
+                        __m256i lo = _mm256_mulhi_epu16(_mm256_unpacklo_epi8(zero, x), g);
+                        __m256i hi = _mm256_mulhi_epu16(_mm256_unpackhi_epi8(zero, x), g);
+                        lo = _mm256_adds_epi16(lo, o);
+                        hi = _mm256_adds_epi16(hi, o);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_packus_epi16(lo, hi));
+                    }
+                    break;
+                }
+                case PixelOp::THRESHOLD: {
+                    if (thresh == 255)
+                        break;
+                    const __m256i t1 = _mm256_set1_epi8(char(thresh + 1));
+                    const __m256i m = _mm256_set1_epi8(char(maxValue));
+                    for (; i + 32 <= n; i += 32) {
+                        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                        __m256i mask = _mm256_cmpeq_epi8(_mm256_max_epu8(x, t1), x);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_and_si256(mask, m));
+                    }
+                    break;
+                }
+                case PixelOp::LUT:
+                    break;
+            }
+            return i;
+        }
+#endif
+    }
+
+    //==============================================================================
+    SimdLevel DetectSimdLevel() {
+#ifdef PIXEL_OP_X86
+        static const SimdLevel level = __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::SSE;
+        return level;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }
+
+    //==============================================================================
+    const char *SimdLevelName(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::SCALAR:
+                return "SCALAR";
+            case SimdLevel::SSE:
+                return "SSE";
+            case SimdLevel::AVX2:
+                return "AVX2";
+        }
+        return "?";
+    }
+
+    //==============================================================================
+    PixelOp PixelOp::Invert() {
+        PixelOp op;
+        op.kind = INVERT;
+        return op;
+    }
+
+    //==============================================================================
+    PixelOp PixelOp::Gain(double gain, int offset) {
+        PixelOp op;
+        op.kind = GAIN;
+        // 255 * 127.99 still fits into int16 in the SIMD kernels
+        op.gain256 = uint16(std::lround(std::min(std::max(gain, 0.0), 127.99) * 256));
+        op.offset = int16(std::min(std::max(offset, -255), 255));
+        return op;
+    }
+
+    //==============================================================================
+    PixelOp PixelOp::Threshold(int thresh, int maxValue) {
+        PixelOp op;
+        op.kind = THRESHOLD;
+        op.thresh = uint8(std::min(std::max(thresh, 0), 255));
+        op.maxValue = uint8(std::min(std::max(maxValue, 0), 255));
+        return op;
+    }
+
+    //==============================================================================
+    PixelOp PixelOp::Lut(const std::array<uint8, 256> &table) {
+        PixelOp op;
+        op.kind = LUT;
+        op.table = table;
+        return op;
+    }
+
+    //==============================================================================
+    void PixelOp::ApplyRow(uint8 *dst, const uint8 *src, int64 n, SimdLevel level) const {
+        int64 done = 0;
+        // Never use a level the CPU does not have
+        level = std::min(level, DetectSimdLevel());
+#ifdef PIXEL_OP_X86
+        if (level == SimdLevel::AVX2)
+            done = avx2Row(kind, dst, src, n, gain256, offset, thresh, maxValue);
+        // What is left after AVX2 can still contain whole 16-byte blocks
+        if (level >= SimdLevel::SSE)
+            done += sseRow(kind, dst + done, src + done, n - done, gain256, offset, thresh, maxValue);
+#endif
+        scalarRow(kind, dst + done, src + done, n - done, gain256, offset, thresh, maxValue, table.data());
+    }
+
+    //==============================================================================
+    void PixelOp::ApplyRect(uint8 *dst, int64 dstStep, const uint8 *src, int64 srcStep,
+                            int64 rowBytes, int rows, SimdLevel level) const {
+        if (dstStep == rowBytes && srcStep == rowBytes) {
+            ApplyRow(dst, src, rowBytes * rows, level);
+            return;
+        }
+        for (int r = 0; r < rows; ++r)
+            ApplyRow(dst + r * dstStep, src + r * srcStep, rowBytes, level);
+    }
+}
+//==============================================================================
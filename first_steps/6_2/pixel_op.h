@@ -0,0 +1,63 @@
+#pragma once
+// Per-byte pixel operations with SIMD (AVX2, SSE2) and scalar kernels
+
+#include <array>
+
+#include "mediapipe/framework/port/integral_types.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Kernel implementation level, SSE means SSE2 here (always present on x86-64)
+    enum class SimdLevel {
+        SCALAR = 0,
+        SSE = 1,
+        AVX2 = 2
+    };
+
+    /// The best level supported by this CPU (SCALAR on non-x86)
+    SimdLevel DetectSimdLevel();
+
+    const char *SimdLevelName(SimdLevel level);
+
+    /// A pixel operation applied to each byte (each channel of each pixel) independently
+    /// dst = ~src                           (INVERT)
+    /// dst = sat(src * gain + offset)       (GAIN, gain in [0, 127], 8 fractional bits)
+    /// dst = src > thresh ? maxValue : 0    (THRESHOLD)
+    /// dst = table[src]                     (LUT, no SIMD kernel: there is no byte gather in AVX2)
+    /// All levels give bit-exact identical results
+    class PixelOp {
+    public:
+        enum Kind {
+            INVERT,
+            GAIN,
+            THRESHOLD,
+            LUT
+        };
+
+        static PixelOp Invert();
+
+        static PixelOp Gain(double gain, int offset);
+
+        static PixelOp Threshold(int thresh, int maxValue);
+
+        static PixelOp Lut(const std::array<uint8, 256> &table);
+
+        Kind GetKind() const { return kind; }
+
+        /// Apply to n bytes, dst == src is allowed (in-place)
+        void ApplyRow(uint8 *dst, const uint8 *src, int64 n, SimdLevel level) const;
+
+        /// Apply to a rectangle of rows x rowBytes bytes, dst == src is allowed
+        /// If both rectangles are contiguous (step == rowBytes), it is processed as one row
+        void ApplyRect(uint8 *dst, int64 dstStep, const uint8 *src, int64 srcStep,
+                       int64 rowBytes, int rows, SimdLevel level) const;
+
+    private:
+        Kind kind = INVERT;
+        uint16 gain256 = 256;   /// gain * 256
+        int16 offset = 0;
+        uint8 thresh = 0, maxValue = 255;
+        std::array<uint8, 256> table;
+    };
+}
+//==============================================================================
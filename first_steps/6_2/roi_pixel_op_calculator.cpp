@@ -0,0 +1,140 @@
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+
+#include "mediapipe/examples/first_steps/6_2/pixel_op.h"
+#include "mediapipe/examples/first_steps/6_2/roi_pixel_op_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// A general version of what SlowCalculator does (photo negative of the central 1/9), without the delay
+    /// Applies a PixelOp (invert, gain, threshold, gamma LUT) to a ROI of the frame with SIMD kernels
+    /// The ROI comes from the options (normalized), or from the optional RECT input stream (Rect, pixels,
+    /// rotation is ignored), the last received RECT is used for frames without one
+    /// In-place: if nobody else holds the input packet (refcount == 1), we take the ImageFrame out
+    /// of the packet with Consume(), modify the ROI and send the same ImageFrame further, no copying
+    /// Otherwise the frame is copied, and the copy and the op are done in one pass
+    class RoiPixelOpCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            if (cc->Inputs().HasTag("RECT"))
+                cc->Inputs().Tag("RECT").Set<Rect>();
+            cc->Outputs().Tag("IMAGE").Set<ImageFrame>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            using namespace std;
+            options = cc->Options<RoiPixelOpCalculatorOptions>();
+            switch (options.op()) {
+                case RoiPixelOpCalculatorOptions::INVERT:
+                    op = PixelOp::Invert();
+                    break;
+                case RoiPixelOpCalculatorOptions::GAIN:
+                    op = PixelOp::Gain(options.gain(), options.offset());
+                    break;
+                case RoiPixelOpCalculatorOptions::THRESHOLD:
+                    op = PixelOp::Threshold(options.threshold(), options.max_value());
+                    break;
+                case RoiPixelOpCalculatorOptions::GAMMA: {
+                    array<uint8, 256> table;
+                    for (int i = 0; i < 256; ++i)
+                        table[i] = uint8(lround(255 * pow(i / 255.0, options.gamma())));
+                    op = PixelOp::Lut(table);
+                    break;
+                }
+            }
+            level = options.simd() == RoiPixelOpCalculatorOptions::AUTO ? DetectSimdLevel() :
+                    SimdLevel(options.simd() - 1);
+            cout << "RoiPixelOpCalculator : SIMD = " << SimdLevelName(min(level, DetectSimdLevel())) << endl;
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            using namespace std;
+            if (cc->Inputs().HasTag("RECT") && !cc->Inputs().Tag("RECT").IsEmpty()) {
+                const Rect &r = cc->Inputs().Tag("RECT").Get<Rect>();
+                rect = cv::Rect(r.x_center() - r.width() / 2, r.y_center() - r.height() / 2, r.width(), r.height());
+                haveRect = true;
+            }
+            // A non-const reference: Consume() takes the ImageFrame out of the packet
+            Packet &pIn = cc->Inputs().Tag("IMAGE").Value();
+            if (pIn.IsEmpty())
+                return OkStatus();
+            const ImageFrame &inFrame = pIn.Get<ImageFrame>();
+            if (inFrame.ByteDepth() != 1)
+                return absl::InvalidArgumentError("RoiPixelOpCalculator : only 8 bit per channel images are supported !");
+            cv::Rect roi = getRoi(inFrame.Width(), inFrame.Height());
+            const int64 pixelBytes = inFrame.NumberOfChannels();
+
+            unique_ptr<ImageFrame> frame;
+            if (options.in_place()) {
+                auto result = pIn.Consume<ImageFrame>();
+                if (result.ok())
+                    frame = move(result).ValueOrDie();
+            }
+            if (frame) {
+                // In place, only the ROI is touched
+                numInPlace++;
+                uint8 *p = frame->MutablePixelData() + roi.y * int64(frame->WidthStep()) + roi.x * pixelBytes;
+                op.ApplyRect(p, frame->WidthStep(), p, frame->WidthStep(), roi.width * pixelBytes, roi.height, level);
+            } else {
+                // Copy the rows, the ROI part goes through the op instead of memcpy
+                numCopied++;
+                frame.reset(new ImageFrame(inFrame.Format(), inFrame.Width(), inFrame.Height(),
+                                           ImageFrame::kDefaultAlignmentBoundary));
+                const int64 rowBytes = inFrame.Width() * pixelBytes;
+                const int64 left = roi.x * pixelBytes, mid = roi.width * pixelBytes;
+                for (int y = 0; y < inFrame.Height(); ++y) {
+                    const uint8 *src = inFrame.PixelData() + y * int64(inFrame.WidthStep());
+                    uint8 *dst = frame->MutablePixelData() + y * int64(frame->WidthStep());
+                    if (y < roi.y || y >= roi.y + roi.height) {
+                        memcpy(dst, src, rowBytes);
+                    } else {
+                        memcpy(dst, src, left);
+                        op.ApplyRow(dst + left, src + left, mid, level);
+                        memcpy(dst + left + mid, src + left + mid, rowBytes - left - mid);
+                    }
+                }
+            }
+            cc->Outputs().Tag("IMAGE").Add(frame.release(), cc->InputTimestamp());
+            return OkStatus();
+        }
+
+        Status Close(CalculatorContext *cc) override {
+            using namespace std;
+            cout << "RoiPixelOpCalculator : in place = " << numInPlace << ", copied = " << numCopied << endl;
+            return OkStatus();
+        }
+
+    private:
+        /// The ROI in pixels, clipped to the image
+        cv::Rect getRoi(int w, int h) const {
+            cv::Rect r = haveRect ? rect :
+                         cv::Rect(cvRound(options.norm_x() * w), cvRound(options.norm_y() * h),
+                                  cvRound(options.norm_width() * w), cvRound(options.norm_height() * h));
+            r &= cv::Rect(0, 0, w, h);
+            return r;
+        }
+
+        RoiPixelOpCalculatorOptions options;
+        PixelOp op;
+        SimdLevel level = SimdLevel::SCALAR;
+        bool haveRect = false;
+        cv::Rect rect;
+        uint64 numInPlace = 0, numCopied = 0;
+    };
+    REGISTER_CALCULATOR(RoiPixelOpCalculator);
+}
+//==============================================================================
@@ -0,0 +1,92 @@
+#include <iostream>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/6_3/change_gate_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Passes a frame only if it differs from the last passed frame, put it before expensive nodes
+    /// The score is the mean absolute difference of small grayscale thumbnails (32x24 by default),
+    /// which costs one cv::resize(INTER_AREA) of the frame, much less than any real processing
+    /// A skipped frame produces no packet, but the output timestamp bound advances past it,
+    /// so downstream nodes (e.g. HoldLastCalculator) do not wait for it
+    /// Outputs: IMAGE (the same packet, no copying), optional SCORE (double, for every frame)
+    class ChangeGateCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            cc->Outputs().Tag("IMAGE").Set<ImageFrame>();
+            if (cc->Outputs().HasTag("SCORE"))
+                cc->Outputs().Tag("SCORE").Set<double>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<ChangeGateCalculatorOptions>();
+            cc->SetOffset(0);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            using namespace std;
+            const Packet &pIn = cc->Inputs().Tag("IMAGE").Value();
+            const ImageFrame &frame = pIn.Get<ImageFrame>();
+            cv::Mat img = formats::MatView(&frame);
+
+            // Grayscale thumbnail: resize first, then convert only the few thumbnail pixels
+            cv::resize(img, thumbColor, cv::Size(options.thumb_width(), options.thumb_height()), 0, 0,
+                       cv::INTER_AREA);
+            if (thumbColor.channels() == 1)
+                thumbColor.copyTo(thumb);
+            else
+                cv::cvtColor(thumbColor, thumb, thumbColor.channels() == 4 ? cv::COLOR_RGBA2GRAY : cv::COLOR_RGB2GRAY);
+
+            // The first frame always passes
+            double score = lastThumb.empty() ? 255.0 : cv::norm(thumb, lastThumb, cv::NORM_L1) / thumb.total();
+            bool pass = score >= options.threshold() ||
+                        (options.max_skip() > 0 && numSkippedInRow >= options.max_skip());
+            numFrames++;
+            if (pass) {
+                numPassed++;
+                numSkippedInRow = 0;
+                swap(thumb, lastThumb);
+                cc->Outputs().Tag("IMAGE").AddPacket(pIn);
+            } else {
+                numSkippedInRow++;
+                // SetOffset(0) would do this too, but let us be explicit
+                cc->Outputs().Tag("IMAGE").SetNextTimestampBound(cc->InputTimestamp().NextAllowedInStream());
+            }
+            if (cc->Outputs().HasTag("SCORE"))
+                cc->Outputs().Tag("SCORE").AddPacket(MakePacket<double>(score).At(cc->InputTimestamp()));
+            if (options.stats_every() > 0 && numFrames % options.stats_every() == 0)
+                printStats();
+            return OkStatus();
+        }
+
+        Status Close(CalculatorContext *cc) override {
+            printStats();
+            return OkStatus();
+        }
+
+    private:
+        void printStats() const {
+            using namespace std;
+            cout << "ChangeGateCalculator : frames = " << numFrames << ", passed = " << numPassed
+                 << " (" << (numFrames > 0 ? 100.0 * numPassed / numFrames : 0.0) << " %)" << endl;
+        }
+
+        ChangeGateCalculatorOptions options;
+        cv::Mat thumbColor, thumb, lastThumb;
+        int numSkippedInRow = 0;
+        uint64 numFrames = 0, numPassed = 0;
+    };
+    REGISTER_CALCULATOR(ChangeGateCalculator);
+}
+//==============================================================================
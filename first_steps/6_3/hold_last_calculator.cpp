@@ -0,0 +1,41 @@
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Re-emits the last RESULT packet at every TICK timestamp
+    /// Put it after a gated expensive node: TICK is the ungated stream, RESULT is the node output
+    /// For a frame which passed the gate, we wait for its result as usual (default input stream handler)
+    /// For a skipped frame, the RESULT timestamp bound has already advanced past it,
+    /// so Process() is called right away with an empty RESULT, and we send the previous result again
+    /// Re-emitting is cheap: the new packet shares the data of the old one, only the timestamp differs
+    /// RESULT can be any type, the output has the same type
+    class HoldLastCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("TICK").SetAny();
+            cc->Inputs().Tag("RESULT").SetAny();
+            cc->Outputs().Tag("RESULT").SetSameAs(&cc->Inputs().Tag("RESULT"));
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            cc->SetOffset(0);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            if (!cc->Inputs().Tag("RESULT").IsEmpty())
+                last = cc->Inputs().Tag("RESULT").Value();
+            // Nothing to re-emit before the first result
+            if (!cc->Inputs().Tag("TICK").IsEmpty() && !last.IsEmpty())
+                cc->Outputs().Tag("RESULT").AddPacket(last.At(cc->InputTimestamp()));
+            return OkStatus();
+        }
+
+    private:
+        Packet last;
+    };
+    REGISTER_CALCULATOR(HoldLastCalculator);
+}
+//==============================================================================
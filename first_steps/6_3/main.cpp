@@ -0,0 +1,183 @@
+/// Example 6.3 : Skipping unchanged frames with a change-detection gate
+/// By Oleksiy Grechnyev, IT-JIM
+/// In 3.1 and 3.2 every frame goes to SlowCalculator, even if the camera looks at a static scene
+/// Here ChangeGateCalculator compares a tiny thumbnail of each frame with the last forwarded one,
+/// and passes the frame to SlowCalculator only if it has changed enough
+/// HoldLastCalculator then re-emits the last SlowCalculator result for the skipped frames,
+/// so "out" still has a packet for every frame which passed FlowLimiterCalculator
+/// On a static scene almost nothing reaches SlowCalculator, and the output runs at the camera FPS
+/// Wave your hand in front of the camera to see the difference
+/// Usage: 6_3 [gate|nogate], nogate is the graph of 3.2 for comparison
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+//==============================================================================
+mediapipe::Status run(bool useGate) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // The graph of 3.2
+    string protoNoGate = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "FlowLimiterCalculator"
+            input_stream: "in"
+            input_stream: "FINISHED:out"
+            input_stream_info: {
+                tag_index: "FINISHED"
+                back_edge: true
+            }
+            output_stream: "out1"
+        }
+        node {
+            calculator: "SlowCalculator"
+            input_stream: "IMAGE:out1"
+            output_stream: "IMAGE:out"
+        }
+        )";
+
+    // The same with the gate and HoldLastCalculator
+    // FlowLimiterCalculator is still needed for the frames which do change
+    string protoGate = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "FlowLimiterCalculator"
+            input_stream: "in"
+            input_stream: "FINISHED:out"
+            input_stream_info: {
+                tag_index: "FINISHED"
+                back_edge: true
+            }
+            output_stream: "out1"
+        }
+        node {
+            calculator: "ChangeGateCalculator"
+            input_stream: "IMAGE:out1"
+            output_stream: "IMAGE:changed"
+            options: {
+                [mediapipe.ChangeGateCalculatorOptions.ext] {
+                    threshold: 3.0
+                    max_skip: 300
+                }
+            }
+        }
+        node {
+            calculator: "SlowCalculator"
+            input_stream: "IMAGE:changed"
+            output_stream: "IMAGE:processed"
+        }
+        node {
+            calculator: "HoldLastCalculator"
+            input_stream: "TICK:out1"
+            input_stream: "RESULT:processed"
+            output_stream: "RESULT:out"
+        }
+        )";
+
+    // Parse config and create graph
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(useGate ? protoGate : protoNoGate, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    // Mutex protecting imshow() and the stop flag
+    mutex mutexImshow;
+    atomic_bool flagStop(false);
+    // Output frames, to print the output FPS
+    atomic_int numOut(0);
+
+    // Add observer to "out", then start the graph
+    auto cb = [&mutexImshow, &flagStop, &numOut](const Packet &packet)->Status{
+        numOut++;
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        {
+            lock_guard<mutex> lock(mutexImshow);
+            cv::imshow("frameOut", frameOut);
+            if (27 == cv::waitKey(1)){
+                cout << "It's time to QUIT !" << endl;
+                flagStop = true;
+            }
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // Start the camera and check that it works
+    cv::VideoCapture cap(cv::CAP_ANY);
+    if (!cap.isOpened())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    cv::Mat frameIn, frameInRGB;
+
+    // Camera loop, runs until we get flagStop == true
+    auto tLast = chrono::steady_clock::now();
+    for (int i=0; !flagStop ; ++i){
+        cap.read(frameIn);
+        if (frameIn.empty())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+        {
+            lock_guard<mutex> lock(mutexImshow);
+            cv::imshow("frameIn", frameIn);
+        }
+
+        // Convert it to a packet and send
+        cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+        ImageFrame *inputFrame =  new ImageFrame(
+            ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary
+        );
+        frameInRGB.copyTo(formats::MatView(inputFrame));
+        Timestamp ts(i);
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in",
+            Adopt(inputFrame).At(ts)
+        ));
+
+        // Output FPS once a second
+        auto t = chrono::steady_clock::now();
+        double sec = chrono::duration<double>(t - tLast).count();
+        if (sec >= 1.0) {
+            cout << "OUTPUT FPS = " << numOut.exchange(0) / sec << endl;
+            tLast = t;
+        }
+    }
+    // Close the input streams, Wait for the graph to finish
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 6.3 : Skipping unchanged frames with a change-detection gate" << endl;
+    bool useGate = !(argc > 1 && string(argv[1]) == "nogate");
+    mediapipe::Status status = run(useGate);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <memory>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/6_4/result_cache.h"
+#include "mediapipe/examples/first_steps/6_4/cache_lookup_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// The first half of the cache wrapper around a pure image calculator (same output for the same image)
+    /// Hashes the input frame (FrameHash64, with the salt from the options) and looks it up in the CACHE
+    /// Hit: the cached result goes to HIT with the new timestamp, the wrapped calculator gets nothing
+    /// Miss: the frame goes to MISS (connect it to the wrapped calculator) and its hash to KEY
+    /// Optional PENDING: a frame whose key is being computed right now (a duplicate arriving within the latency
+    /// of the wrapped calculator) does not go to MISS again, its key goes to PENDING, and CacheStoreCalculator
+    /// sends the result of the first computation at this timestamp (see ResultCache::LookupOrReserve())
+    /// Without PENDING every such duplicate is a miss and is computed again
+    /// CacheStoreCalculator (the second half) stores the result and merges the paths
+    /// Side packet CACHE : std::shared_ptr<ResultCache>, the same for both halves
+    class CacheLookupCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            cc->InputSidePackets().Tag("CACHE").Set<std::shared_ptr<ResultCache>>();
+            cc->Outputs().Tag("MISS").Set<ImageFrame>();
+            cc->Outputs().Tag("KEY").Set<uint64>();
+            cc->Outputs().Tag("HIT").SetAny();
+            if (cc->Outputs().HasTag("PENDING"))
+                cc->Outputs().Tag("PENDING").Set<uint64>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            cache = cc->InputSidePackets().Tag("CACHE").Get<std::shared_ptr<ResultCache>>();
+            seed = StringHash64(cc->Options<CacheLookupCalculatorOptions>().salt());
+            // Timestamp bounds of all outputs follow the input, so that the outputs without packets
+            // do not hold up the downstream nodes
+            cc->SetOffset(0);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            const Packet &pIn = cc->Inputs().Tag("IMAGE").Value();
+            uint64 key = FrameHash64(pIn.Get<ImageFrame>(), seed);
+            Packet cached;
+            CacheLookup res;
+            if (cc->Outputs().HasTag("PENDING"))
+                res = cache->LookupOrReserve(key, &cached);
+            else
+                res = cache->Lookup(key, &cached) ? CacheLookup::HIT : CacheLookup::MISS;
+            switch (res) {
+                case CacheLookup::HIT:
+                    // Shares the data with the cached packet, no copying
+                    cc->Outputs().Tag("HIT").AddPacket(cached.At(cc->InputTimestamp()));
+                    break;
+                case CacheLookup::PENDING:
+                    cc->Outputs().Tag("PENDING").AddPacket(MakePacket<uint64>(key).At(cc->InputTimestamp()));
+                    break;
+                case CacheLookup::MISS:
+                    cc->Outputs().Tag("MISS").AddPacket(pIn);
+                    cc->Outputs().Tag("KEY").AddPacket(MakePacket<uint64>(key).At(cc->InputTimestamp()));
+                    break;
+            }
+            return OkStatus();
+        }
+
+    private:
+        std::shared_ptr<ResultCache> cache;
+        uint64 seed = 0;
+    };
+    REGISTER_CALCULATOR(CacheLookupCalculator);
+}
+//==============================================================================
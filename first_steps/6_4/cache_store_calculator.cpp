@@ -0,0 +1,72 @@
+#include <iostream>
+#include <memory>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/6_4/result_cache.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// The second half of the cache wrapper, see CacheLookupCalculator
+    /// Inputs: RESULT (the wrapped calculator output), KEY and HIT (from CacheLookupCalculator)
+    /// At each timestamp there is either RESULT + KEY (a miss: we store the result), HIT, or PENDING (optional)
+    /// PENDING: the key was being computed at an earlier timestamp; we process timestamps in order,
+    /// so its result is already stored here, and we send it (if it has not been evicted since)
+    /// KEY without RESULT: the wrapped calculator produced nothing, the key is no longer pending
+    /// Both go to the output RESULT, so downstream nodes see one stream, as without the cache
+    /// Prints the cache statistics in Close()
+    class CacheStoreCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("RESULT").SetAny();
+            cc->Inputs().Tag("KEY").Set<uint64>();
+            cc->Inputs().Tag("HIT").SetAny();
+            if (cc->Inputs().HasTag("PENDING"))
+                cc->Inputs().Tag("PENDING").Set<uint64>();
+            cc->InputSidePackets().Tag("CACHE").Set<std::shared_ptr<ResultCache>>();
+            cc->Outputs().Tag("RESULT").SetSameAs(&cc->Inputs().Tag("RESULT"));
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            cache = cc->InputSidePackets().Tag("CACHE").Get<std::shared_ptr<ResultCache>>();
+            cc->SetOffset(0);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            const auto &result = cc->Inputs().Tag("RESULT");
+            const auto &key = cc->Inputs().Tag("KEY");
+            const auto &hit = cc->Inputs().Tag("HIT");
+            if (!result.IsEmpty()) {
+                if (!key.IsEmpty())
+                    cache->Insert(key.Get<uint64>(), result.Value());
+                cc->Outputs().Tag("RESULT").AddPacket(result.Value());
+            } else if (!hit.IsEmpty()) {
+                cc->Outputs().Tag("RESULT").AddPacket(hit.Value());
+            } else if (cc->Inputs().HasTag("PENDING") && !cc->Inputs().Tag("PENDING").IsEmpty()) {
+                Packet cached;
+                if (cache->Peek(cc->Inputs().Tag("PENDING").Get<uint64>(), &cached))
+                    cc->Outputs().Tag("RESULT").AddPacket(cached.At(cc->InputTimestamp()));
+            } else if (!key.IsEmpty()) {
+                cache->Abandon(key.Get<uint64>());
+            }
+            return OkStatus();
+        }
+
+        Status Close(CalculatorContext *cc) override {
+            using namespace std;
+            ResultCacheStats s = cache->GetStats();
+            cout << "CacheStoreCalculator : lookups = " << s.lookups << ", hit rate = " << s.hitRate * 100
+                 << " %, coalesced = " << s.coalesced << ", entries = " << s.entries << ", memory = "
+                 << s.bytes / 1e6 << " MB, evictions = " << s.evictions << endl;
+            return OkStatus();
+        }
+
+    private:
+        std::shared_ptr<ResultCache> cache;
+    };
+    REGISTER_CALCULATOR(CacheStoreCalculator);
+}
+//==============================================================================
@@ -0,0 +1,185 @@
+/// Example 6.4 : Content-addressed result cache
+/// By Oleksiy Grechnyev, IT-JIM
+/// SlowCalculator is pure: the same image always gives the same result
+/// With looping test footage, replayed recordings or duplicated frames, it computes the same results again and again
+/// Here we wrap it into a cache: CacheLookupCalculator hashes the frame content (64-bit hash, plus a salt
+/// for the options), and on a hit sends the cached result instead of running SlowCalculator;
+/// CacheStoreCalculator stores the new results in a bounded LRU cache (ResultCache) and merges the two paths
+/// The cache is shared by both halves via a side packet
+/// The footage (10 synthetic frames, or the first 25 frames of a video file) is played 5 times in a loop,
+/// each frame twice in a row (duplicated frames, as from a camera driver which repeats frames)
+/// A duplicate arrives while SlowCalculator is still computing the first copy: it is not computed again,
+/// but gets the same result (PENDING, coalesced); each loop starts when all results of the previous one are out,
+/// so after the first loop everything comes from the cache
+/// Usage: 6_4 [cache|nocache] [video_file]
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/port/opencv_video_inc.h"
+
+#include "mediapipe/examples/first_steps/6_4/result_cache.h"
+
+//==============================================================================
+/// Get the footage: RGB frames from a video file, or synthetic ones if the path is empty
+mediapipe::Status loadFootage(const std::string &path, std::vector<cv::Mat> *footage) {
+    using namespace std;
+    if (path.empty()) {
+        // A circle running along the frame
+        for (int i = 0; i < 10; ++i) {
+            cv::Mat img(480, 640, CV_8UC3, cv::Scalar(40, 40, 40));
+            cv::circle(img, cv::Point(50 + 60 * i, 240), 40, cv::Scalar(255, 200, 0), -1);
+            footage->push_back(img);
+        }
+        return mediapipe::OkStatus();
+    }
+    cv::VideoCapture cap(path);
+    if (!cap.isOpened())
+        return absl::NotFoundError("Cannot open video " + path);
+    cv::Mat frameIn, frameInRGB;
+    while (footage->size() < 25 && cap.read(frameIn) && !frameIn.empty()) {
+        cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+        footage->push_back(frameInRGB.clone());
+    }
+    if (footage->empty())
+        return absl::NotFoundError("No frames in " + path);
+    return mediapipe::OkStatus();
+}
+
+//==============================================================================
+mediapipe::Status run(bool useCache, const std::string &path) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // Without the cache: SlowCalculator only
+    string protoNoCache = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "SlowCalculator"
+            input_stream: "IMAGE:in"
+            output_stream: "IMAGE:out"
+        }
+        )";
+
+    // With the cache
+    // The salt must change whenever SlowCalculator or its options change, otherwise we get stale results
+    string protoCache = R"(
+        input_stream: "in"
+        output_stream: "out"
+        input_side_packet: "cache"
+        node {
+            calculator: "CacheLookupCalculator"
+            input_stream: "IMAGE:in"
+            input_side_packet: "CACHE:cache"
+            output_stream: "MISS:miss"
+            output_stream: "KEY:key"
+            output_stream: "HIT:hit"
+            output_stream: "PENDING:pending"
+            options: {
+                [mediapipe.CacheLookupCalculatorOptions.ext] {
+                    salt: "SlowCalculator v1"
+                }
+            }
+        }
+        node {
+            calculator: "SlowCalculator"
+            input_stream: "IMAGE:miss"
+            output_stream: "IMAGE:processed"
+        }
+        node {
+            calculator: "CacheStoreCalculator"
+            input_stream: "RESULT:processed"
+            input_stream: "KEY:key"
+            input_stream: "HIT:hit"
+            input_stream: "PENDING:pending"
+            input_side_packet: "CACHE:cache"
+            output_stream: "RESULT:out"
+        }
+        )";
+
+    vector<cv::Mat> footage;
+    MP_RETURN_IF_ERROR(loadFootage(path, &footage));
+
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(useCache ? protoCache : protoNoCache, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    atomic_int numOut(0);
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", [&numOut](const Packet &packet)->Status{
+        numOut++;
+        return OkStatus();
+    }));
+
+    // Up to 100 results or 256 MB
+    auto cache = make_shared<ResultCache>(100, 256 << 20);
+    map<string, Packet> sidePackets;
+    if (useCache)
+        sidePackets["cache"] = MakePacket<shared_ptr<ResultCache>>(cache);
+    MP_RETURN_IF_ERROR(graph.StartRun(sidePackets));
+
+    // Play the footage 5 times, each frame twice, each frame is a new ImageFrame
+    // (the same content at a different address)
+    const int numLoops = 5;
+    auto t1 = chrono::steady_clock::now();
+    int64 i = 0;
+    for (int loop = 0; loop < numLoops; ++loop) {
+        for (const cv::Mat &img : footage) {
+            for (int dup = 0; dup < 2; ++dup) {
+                ImageFrame *inputFrame =  new ImageFrame(
+                    ImageFormat::SRGB, img.cols, img.rows, ImageFrame::kDefaultAlignmentBoundary
+                );
+                img.copyTo(formats::MatView(inputFrame));
+                MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", Adopt(inputFrame).At(Timestamp(i++))));
+            }
+        }
+        // Replay only when the previous loop is done: its results are in the cache by then
+        while (numOut < i)
+            this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    auto t2 = chrono::steady_clock::now();
+
+    double sec = chrono::duration<double>(t2 - t1).count();
+    cout << (useCache ? "CACHE" : "NO CACHE") << " : " << numOut << " frames in " << sec << " s, "
+         << sec * 1000 / i << " ms/frame" << endl;
+    if (useCache) {
+        ResultCacheStats s = cache->GetStats();
+        cout << "hits = " << s.hits << " / " << s.lookups << ", coalesced = " << s.coalesced << ", memory in use = " << s.bytes / 1e6 << " MB" << endl;
+    }
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 6.4 : Content-addressed result cache" << endl;
+    bool useCache = !(argc > 1 && string(argv[1]) == "nocache");
+    string path = argc > 2 ? argv[2] : "";
+    mediapipe::Status status = run(useCache, path);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <cstring>
+
+#include "mediapipe/examples/first_steps/6_4/result_cache.h"
+
+//==============================================================================
+namespace mediapipe {
+    namespace {
+        constexpr uint64 PRIME1 = 0x9E3779B185EBCA87ULL;
+        constexpr uint64 PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+
+        inline uint64 rotl(uint64 x, int r) {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        /// One lane step, as in xxHash64
+        inline uint64 mixLane(uint64 acc, uint64 w) {
+            acc += w * PRIME2;
+            return rotl(acc, 31) * PRIME1;
+        }
+
+        /// The final avalanche (MurmurHash3 fmix64)
+        inline uint64 fmix(uint64 h) {
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        /// Hash n bytes into 4 lanes
+        void hashBytes(uint64 lanes[4], const uint8 *p, int64 n) {
+            uint64 w[4];
+            int64 i = 0;
+            for (; i + 32 <= n; i += 32) {
+                // memcpy is the portable unaligned load, compiled into a plain mov
+                memcpy(w, p + i, 32);
+                lanes[0] = mixLane(lanes[0], w[0]);
+                lanes[1] = mixLane(lanes[1], w[1]);
+                lanes[2] = mixLane(lanes[2], w[2]);
+                lanes[3] = mixLane(lanes[3], w[3]);
+            }
+            // The tail, zero-padded
+            if (i < n) {
+                memset(w, 0, sizeof(w));
+                memcpy(w, p + i, n - i);
+                for (int k = 0; k < 4; ++k)
+                    lanes[k] = mixLane(lanes[k], w[k] ^ uint64(n - i));
+            }
+        }
+    }
+
+    //==============================================================================
+    uint64 FrameHash64(const ImageFrame &frame, uint64 seed) {
+        uint64 lanes[4] = {seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1};
+        const uint64 header[4] = {uint64(frame.Format()), uint64(frame.Width()), uint64(frame.Height()), 0};
+        hashBytes(lanes, reinterpret_cast<const uint8 *>(header), sizeof(header));
+        const int64 rowBytes = int64(frame.Width()) * frame.NumberOfChannels() * frame.ByteDepth();
+        const uint8 *pixels = frame.PixelData();
+        if (frame.IsContiguous()) {
+            hashBytes(lanes, pixels, rowBytes * frame.Height());
+        } else {
+            // Row by row, the padding bytes are garbage
+            for (int y = 0; y < frame.Height(); ++y)
+                hashBytes(lanes, pixels + y * int64(frame.WidthStep()), rowBytes);
+        }
+        uint64 h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+        return fmix(h);
+    }
+
+    //==============================================================================
+    uint64 StringHash64(const std::string &s) {
+        uint64 lanes[4] = {PRIME1, PRIME2, 0, ~PRIME1};
+        hashBytes(lanes, reinterpret_cast<const uint8 *>(s.data()), s.size());
+        return fmix(lanes[0] ^ rotl(lanes[1], 7) ^ rotl(lanes[2], 12) ^ rotl(lanes[3], 18) ^ s.size());
+    }
+
+    //==============================================================================
+    bool ResultCache::Lookup(uint64 key, Packet *packet) {
+        std::lock_guard<std::mutex> lock(mutexCache);
+        stats.lookups++;
+        auto it = index.find(key);
+        if (it == index.end())
+            return false;
+        stats.hits++;
+        // Move to the front: most recently used
+        lru.splice(lru.begin(), lru, it->second);
+        *packet = it->second->packet;
+        return true;
+    }
+
+    //==============================================================================
+    CacheLookup ResultCache::LookupOrReserve(uint64 key, Packet *packet) {
+        std::lock_guard<std::mutex> lock(mutexCache);
+        stats.lookups++;
+        auto it = index.find(key);
+        if (it != index.end()) {
+            stats.hits++;
+            lru.splice(lru.begin(), lru, it->second);
+            *packet = it->second->packet;
+            return CacheLookup::HIT;
+        }
+        if (!pending.insert(key).second) {
+            stats.coalesced++;
+            return CacheLookup::PENDING;
+        }
+        return CacheLookup::MISS;
+    }
+
+    //==============================================================================
+    bool ResultCache::Peek(uint64 key, Packet *packet) {
+        std::lock_guard<std::mutex> lock(mutexCache);
+        auto it = index.find(key);
+        if (it == index.end())
+            return false;
+        lru.splice(lru.begin(), lru, it->second);
+        *packet = it->second->packet;
+        return true;
+    }
+
+    //==============================================================================
+    void ResultCache::Abandon(uint64 key) {
+        std::lock_guard<std::mutex> lock(mutexCache);
+        pending.erase(key);
+    }
+
+    //==============================================================================
+    void ResultCache::Insert(uint64 key, const Packet &packet) {
+        std::lock_guard<std::mutex> lock(mutexCache);
+        pending.erase(key);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            stats.bytes -= it->second->bytes;
+            lru.erase(it->second);
+            index.erase(it);
+        }
+        uint64 bytes = packetBytes(packet);
+        lru.push_front(Entry{key, packet, bytes});
+        index[key] = lru.begin();
+        stats.bytes += bytes;
+        stats.inserts++;
+        // Evict from the back, but never the entry we have just inserted
+        while (lru.size() > 1 && (lru.size() > maxEntries || stats.bytes > maxBytes)) {
+            stats.bytes -= lru.back().bytes;
+            index.erase(lru.back().key);
+            lru.pop_back();
+            stats.evictions++;
+        }
+    }
+
+    //==============================================================================
+    ResultCacheStats ResultCache::GetStats() const {
+        std::lock_guard<std::mutex> lock(mutexCache);
+        ResultCacheStats s = stats;
+        s.entries = lru.size();
+        s.hitRate = s.lookups > 0 ? double(s.hits) / s.lookups : 0.0;
+        return s;
+    }
+
+    //==============================================================================
+    uint64 ResultCache::packetBytes(const Packet &packet) {
+        if (packet.ValidateAsType<ImageFrame>().ok()) {
+            const ImageFrame &frame = packet.Get<ImageFrame>();
+            return sizeof(ImageFrame) + uint64(frame.WidthStep()) * frame.Height();
+        }
+        return sizeof(Packet);
+    }
+}
+//==============================================================================
@@ -0,0 +1,89 @@
+#pragma once
+// A content-addressed LRU cache of output packets
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// A fast non-cryptographic 64-bit hash of an ImageFrame: format, size and pixels (without row padding)
+    /// 4 independent multiply-xor lanes of 8-byte words, so it runs at several bytes per CPU cycle
+    /// seed is mixed in first, use it for everything else the result depends on (e.g. calculator options)
+    uint64 FrameHash64(const ImageFrame &frame, uint64 seed);
+
+    /// 64-bit hash of a string, e.g. to make a seed for FrameHash64()
+    uint64 StringHash64(const std::string &s);
+
+    /// Statistics of ResultCache
+    struct ResultCacheStats {
+        uint64 lookups = 0;
+        uint64 hits = 0;
+        uint64 coalesced = 0;   /// Lookups of a key which was being computed: no second computation
+        uint64 inserts = 0;
+        uint64 evictions = 0;
+        uint64 entries = 0;
+        uint64 bytes = 0;       /// Memory held by the cached packets (estimated)
+        double hitRate = 0;
+    };
+
+    /// Result of ResultCache::LookupOrReserve()
+    enum class CacheLookup {
+        HIT,      /// The result is in the cache
+        MISS,     /// Not in the cache, the key is now pending: compute it, then Insert() or Abandon()
+        PENDING   /// Somebody is computing it now, wait for its Insert() instead of computing again
+    };
+
+    /// Bounded LRU cache: key (content hash) -> packet
+    /// Thread-safe, as the lookup and store calculators run on different threads
+    /// A packet is kept as is, so a hit costs no copying: the caller only re-timestamps it
+    /// The cache evicts the least recently used entries when it has more than maxEntries entries
+    /// or more than maxBytes bytes
+    class ResultCache {
+    public:
+        ResultCache(uint64 maxEntries, uint64 maxBytes) : maxEntries(maxEntries), maxBytes(maxBytes) {}
+
+        /// Returns true and the packet on a hit
+        bool Lookup(uint64 key, Packet *packet);
+
+        /// Like Lookup(), but a miss makes the key pending, and a lookup of a pending key returns PENDING,
+        /// so that duplicates arriving while the first one is computed do not compute it again
+        CacheLookup LookupOrReserve(uint64 key, Packet *packet);
+
+        /// Get an entry without counting a lookup, e.g. the result for a PENDING lookup after its Insert()
+        bool Peek(uint64 key, Packet *packet);
+
+        /// Insert (or replace) an entry, the key is no longer pending
+        void Insert(uint64 key, const Packet &packet);
+
+        /// The computation of a pending key has failed or produced nothing, the next lookup is a MISS
+        void Abandon(uint64 key);
+
+        ResultCacheStats GetStats() const;
+
+    private:
+        struct Entry {
+            uint64 key;
+            Packet packet;
+            uint64 bytes;
+        };
+
+        /// Pixel bytes for ImageFrame, sizeof(Packet) for other types
+        static uint64 packetBytes(const Packet &packet);
+
+        uint64 maxEntries, maxBytes;
+
+        /// Protects everything below
+        mutable std::mutex mutexCache;
+        std::list<Entry> lru;   /// Most recently used first
+        std::unordered_map<uint64, std::list<Entry>::iterator> index;
+        std::unordered_set<uint64> pending;   /// Keys being computed
+        ResultCacheStats stats;
+    };
+}
+//==============================================================================
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <map>
+#include <chrono>
+#include <algorithm>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/6_5/deadline_queue_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// FlowLimiterCalculator with deadlines
+    /// Packet timestamps must be capture times in microseconds of the monotonic clock (see CaptureThread, 5.4)
+    /// Each frame has a deadline: timestamp + budget_ms, or an absolute time (int64 us, same clock)
+    /// from the optional DEADLINE stream at the same timestamp
+    /// Like FlowLimiterCalculator, we keep at most max_in_flight frames downstream, and use the FINISHED
+    /// back edge to learn when a frame is done. The time from sending a frame to its FINISHED packet
+    /// is the service time of the downstream nodes, we keep its moving average (EWMA)
+    /// As in FlowLimiterCalculator, a slot is also freed when the FINISHED timestamp bound passes a frame
+    /// without a packet (a downstream node dropped it), so dropped frames never hold slots (SetProcessTimestampBounds)
+    /// Frames wait in a small queue, and when a slot is free:
+    /// 1) Frames which cannot finish in time (now + service time > deadline) are dropped
+    /// 2) The frame with the earliest deadline (EDF) is sent
+    /// 3) Queued frames older than it are dropped: a stream cannot go back in time in MP,
+    ///    so EDF can reorder frames only by skipping the older ones
+    /// The expired frames are never sent, so downstream nodes never start work which is stale anyway
+    /// Uses ImmediateInputStreamHandler (set in GetContract), as it must react to any input at once
+    class DeadlineQueueCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").SetAny();
+            if (cc->Inputs().HasTag("DEADLINE"))
+                cc->Inputs().Tag("DEADLINE").Set<int64>();
+            cc->Inputs().Tag("FINISHED").SetAny();
+            cc->Outputs().Tag("IMAGE").SetSameAs(&cc->Inputs().Tag("IMAGE"));
+            cc->SetInputStreamHandler("ImmediateInputStreamHandler");
+            // Process() is called on FINISHED bound updates without packets too
+            cc->SetProcessTimestampBounds(true);
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<DeadlineQueueCalculatorOptions>();
+            serviceUs = options.initial_service_ms() * 1000;
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            int64 now = nowUs();
+            const int64 budgetUs = int64(options.budget_ms() * 1000);
+            // A new frame
+            const auto &image = cc->Inputs().Tag("IMAGE");
+            if (!image.IsEmpty()) {
+                Timestamp ts = image.Value().Timestamp();
+                lastSeen = ts;
+                Item &item = queue[ts];
+                item.frame = image.Value();
+                if (item.deadline < 0)
+                    item.deadline = ts.Value() + budgetUs;
+            }
+            // An explicit deadline, it can come before or after its frame, ignored if the frame is already gone
+            if (cc->Inputs().HasTag("DEADLINE") && !cc->Inputs().Tag("DEADLINE").IsEmpty()) {
+                Timestamp ts = cc->Inputs().Tag("DEADLINE").Value().Timestamp();
+                auto it = queue.find(ts);
+                if (it != queue.end())
+                    it->second.deadline = cc->Inputs().Tag("DEADLINE").Get<int64>();
+                else if (lastSeen == Timestamp::Unset() || ts > lastSeen)
+                    queue[ts].deadline = cc->Inputs().Tag("DEADLINE").Get<int64>();
+            }
+            // A frame is done, and all frames up to the FINISHED bound are done or dropped downstream
+            // Without a packet, the timestamp of the empty FINISHED packet is the settled one (bound - 1)
+            const auto &finished = cc->Inputs().Tag("FINISHED");
+            Timestamp settled = finished.Value().Timestamp();
+            if (settled != Timestamp::Unset()) {
+                for (auto it = inFlight.begin(); it != inFlight.end() && it->first <= settled;) {
+                    if (it->first == settled && !finished.IsEmpty()) {
+                        double t = now - it->second.sent;
+                        serviceUs = numMeasured == 0 ? t : options.ewma_alpha() * t + (1 - options.ewma_alpha()) * serviceUs;
+                        numMeasured++;
+                        if (now > it->second.deadline)
+                            numMissed++;
+                    } else {
+                        numReleased++;
+                    }
+                    it = inFlight.erase(it);
+                }
+            }
+            admit(cc, now);
+            return OkStatus();
+        }
+
+        Status Close(CalculatorContext *cc) override {
+            printStats();
+            return OkStatus();
+        }
+
+    private:
+        struct Item {
+            Packet frame;        /// Empty if only the deadline has come so far
+            int64 deadline = -1;
+        };
+
+        struct Sent {
+            int64 sent;
+            int64 deadline;
+        };
+
+        static int64 nowUs() {
+            using namespace std::chrono;
+            return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        /// Drop what cannot finish in time, send frames while there are free slots, set the timestamp bound
+        void admit(CalculatorContext *cc, int64 now) {
+            using namespace std;
+            // Expired frames
+            for (auto it = queue.begin(); it != queue.end();) {
+                if (!it->second.frame.IsEmpty() && now + serviceUs > it->second.deadline) {
+                    numExpired++;
+                    it = queue.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            // Queue overflow, drop the oldest
+            while (countFrames() > options.max_queue()) {
+                numOverflow++;
+                queue.erase(firstFrame());
+            }
+            // EDF
+            while (int(inFlight.size()) < options.max_in_flight()) {
+                auto best = queue.end();
+                for (auto it = queue.begin(); it != queue.end(); ++it)
+                    if (!it->second.frame.IsEmpty() && (best == queue.end() || it->second.deadline < best->second.deadline))
+                        best = it;
+                if (best == queue.end())
+                    break;
+                for (auto it = queue.begin(); it != best; ++it)
+                    if (!it->second.frame.IsEmpty())
+                        numSkipped++;
+                Timestamp ts = best->first;
+                inFlight[ts] = Sent{now, best->second.deadline};
+                cc->Outputs().Tag("IMAGE").AddPacket(best->second.frame);
+                lastSent = ts;
+                queue.erase(queue.begin(), next(best));
+                numSent++;
+                if (options.stats_every() > 0 && numSent % options.stats_every() == 0)
+                    printStats();
+            }
+            // Deadlines without a frame, if the frame can no longer come
+            while (!queue.empty() && queue.begin()->second.frame.IsEmpty() &&
+                   lastSeen != Timestamp::Unset() && queue.begin()->first <= lastSeen)
+                queue.erase(queue.begin());
+
+            // Nothing will be sent below the oldest queued timestamp, or below the next input
+            if (lastSeen == Timestamp::Unset())
+                return;
+            Timestamp bound = lastSeen.NextAllowedInStream();
+            if (!queue.empty())
+                bound = min(bound, queue.begin()->first);
+            if (lastSent != Timestamp::Unset())
+                bound = max(bound, lastSent.NextAllowedInStream());
+            cc->Outputs().Tag("IMAGE").SetNextTimestampBound(bound);
+        }
+
+        int countFrames() const {
+            int n = 0;
+            for (const auto &p : queue)
+                if (!p.second.frame.IsEmpty())
+                    n++;
+            return n;
+        }
+
+        std::map<Timestamp, Item>::iterator firstFrame() {
+            auto it = queue.begin();
+            while (it != queue.end() && it->second.frame.IsEmpty())
+                ++it;
+            return it;
+        }
+
+        void printStats() const {
+            using namespace std;
+            cout << "DeadlineQueueCalculator : sent = " << numSent << ", expired = " << numExpired
+                 << ", skipped (EDF) = " << numSkipped << ", overflow = " << numOverflow
+                 << ", missed deadline = " << numMissed << ", dropped downstream = " << numReleased
+                 << ", service time = " << serviceUs / 1000 << " ms" << endl;
+        }
+
+        DeadlineQueueCalculatorOptions options;
+        std::map<Timestamp, Item> queue;
+        std::map<Timestamp, Sent> inFlight;
+        Timestamp lastSeen = Timestamp::Unset();     /// Last IMAGE timestamp
+        Timestamp lastSent = Timestamp::Unset();
+        double serviceUs = 0;
+        uint64 numMeasured = 0, numSent = 0, numExpired = 0, numSkipped = 0, numOverflow = 0, numMissed = 0;
+        uint64 numReleased = 0;   /// Freed by the FINISHED bound without a packet
+    };
+    REGISTER_CALCULATOR(DeadlineQueueCalculator);
+}
+//==============================================================================
@@ -0,0 +1,146 @@
+/// Example 6.5 : Deadline-aware frame dropping
+/// By Oleksiy Grechnyev, IT-JIM
+/// In 3.2 FlowLimiterCalculator sends a frame to SlowCalculator whenever it is free,
+/// no matter how old the frame already is, so the result can be stale on arrival
+/// Here each frame has a deadline: capture time + budget. DeadlineQueueCalculator measures the service time
+/// of SlowCalculator (moving average), drops the queued frames which cannot finish in time,
+/// and sends the one with the earliest deadline
+/// The camera runs on CaptureThread from 5.4, so that packet timestamps are capture times in microseconds
+/// The observer prints the latency of each output frame, and counts the frames which came too late
+/// Usage: 6_5 [deadline|flow] [budget_ms=300], flow is the graph of 3.2 for comparison
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/5_4/capture_thread.h"
+
+//==============================================================================
+mediapipe::Status run(bool useDeadline, double budgetMs) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // The graph of 3.2
+    string protoFlow = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "FlowLimiterCalculator"
+            input_stream: "in"
+            input_stream: "FINISHED:out"
+            input_stream_info: {
+                tag_index: "FINISHED"
+                back_edge: true
+            }
+            output_stream: "out1"
+        }
+        node {
+            calculator: "SlowCalculator"
+            input_stream: "IMAGE:out1"
+            output_stream: "IMAGE:out"
+        }
+        )";
+
+    // The same with DeadlineQueueCalculator
+    string protoDeadline = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "DeadlineQueueCalculator"
+            input_stream: "IMAGE:in"
+            input_stream: "FINISHED:out"
+            input_stream_info: {
+                tag_index: "FINISHED"
+                back_edge: true
+            }
+            output_stream: "IMAGE:out1"
+            options: {
+                [mediapipe.DeadlineQueueCalculatorOptions.ext] {
+                    budget_ms: )" + to_string(budgetMs) + R"(
+                    max_in_flight: 1
+                    max_queue: 2
+                }
+            }
+        }
+        node {
+            calculator: "SlowCalculator"
+            input_stream: "IMAGE:out1"
+            output_stream: "IMAGE:out"
+        }
+        )";
+
+    // Parse config and create graph
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(useDeadline ? protoDeadline : protoFlow, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    atomic_bool flagStop(false);
+    atomic_int numOut(0), numLate(0);
+
+    // The observer displays the frame and checks the latency
+    auto cb = [&flagStop, &numOut, &numLate, budgetMs](const Packet &packet)->Status{
+        double latencyMs = (CaptureThread::NowUs() - packet.Timestamp().Value()) / 1000.;
+        numOut++;
+        if (latencyMs > budgetMs)
+            numLate++;
+        cout << packet.Timestamp() << ": RECEIVED VIDEO PACKET, latency = " << latencyMs << " ms"
+             << (latencyMs > budgetMs ? " LATE !" : "") << endl;
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        cv::imshow("frameOut", frameOut);
+        if (27 == cv::waitKey(1)){
+            cout << "It's time to QUIT !" << endl;
+            flagStop = true;
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // Start the capture, it runs until Stop()
+    CaptureThread capture;
+    MP_RETURN_IF_ERROR(capture.Start(&graph, "in"));
+    while (!flagStop && !capture.IsDone())
+        this_thread::sleep_for(chrono::milliseconds(100));
+    Status status = capture.Stop();
+
+    // Close the input streams, Wait for the graph to finish
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    cout << "OUTPUT FRAMES = " << numOut << ", LATE (> " << budgetMs << " ms) = " << numLate << endl;
+    return status;
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 6.5 : Deadline-aware frame dropping" << endl;
+    bool useDeadline = !(argc > 1 && string(argv[1]) == "flow");
+    double budgetMs = argc > 2 ? stod(argv[2]) : 300;
+    mediapipe::Status status = run(useDeadline, budgetMs);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
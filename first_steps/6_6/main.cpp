@@ -0,0 +1,143 @@
+/// Example 6.6 : Graceful degradation under load
+/// By Oleksiy Grechnyev, IT-JIM
+/// The graph scales the frame and detects ORB keypoints on it, as 2.2 and 2.4, but with QoS (quality of service):
+/// QosControllerCalculator watches the latency and the number of frames inside the graph,
+/// and under overload switches the participating calculators to cheaper settings at runtime
+/// (smaller size, LINEAR/AREA instead of CUBIC, fewer keypoints), and back when the load drops
+/// Participants opt in via the QosParticipant interface (qos.h) and the side packet QOS (QosBoard)
+/// There is no FlowLimiterCalculator, so without QoS the lag grows if the computer is too slow
+/// The camera runs on CaptureThread from 5.4, so that packet timestamps are capture times in microseconds
+/// Usage: 6_6 [qos|noqos]
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <map>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/5_4/capture_thread.h"
+#include "mediapipe/examples/first_steps/6_6/qos.h"
+
+//==============================================================================
+mediapipe::Status run(bool useQos) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // Without QoS, the participants simply have no QOS side packet, and stay at level 0 (FULL)
+    string sideQos = useQos ? R"(input_side_packet: "QOS:qos")" : "";
+    string protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "QosScaleCalculator"
+            input_stream: "IMAGE:in"
+            output_stream: "IMAGE:scaled"
+            )" + sideQos + R"(
+        }
+        node {
+            calculator: "QosFeatureDetectorCalculator"
+            input_stream: "IMAGE:scaled"
+            output_stream: "FEATURES:feat"
+            )" + sideQos + R"(
+        }
+        node {
+            calculator: "DrawFeatCalculator24"
+            input_stream: "IMAGE:scaled"
+            input_stream: "FEATURES:feat"
+            output_stream: "IMAGE:out"
+        }
+        )";
+    if (useQos)
+        protoG += R"(
+        input_side_packet: "qos"
+        node {
+            calculator: "QosControllerCalculator"
+            input_stream: "IN:in"
+            input_stream: "OUT:out"
+            input_stream_info: {
+                tag_index: "OUT"
+                back_edge: true
+            }
+            input_side_packet: "QOS:qos"
+            options: {
+                [mediapipe.QosControllerCalculatorOptions.ext] {
+                    high_latency_ms: 150
+                    low_latency_ms: 60
+                }
+            }
+        }
+        )";
+
+    // Parse config and create graph
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    auto board = make_shared<QosBoard>();
+    atomic_bool flagStop(false);
+
+    // The observer displays the frame with the latency and the QoS level
+    auto cb = [&flagStop, board](const Packet &packet)->Status{
+        double latencyMs = (CaptureThread::NowUs() - packet.Timestamp().Value()) / 1000.;
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        string text = string(QosBoard::LevelName(board->Level())) + " " + to_string(frameOut.cols) + "x" +
+                      to_string(frameOut.rows) + " latency " + to_string(int(latencyMs)) + " ms";
+        cv::putText(frameOut, text, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 255, 0), 2);
+        cv::imshow("frameOut", frameOut);
+        if (27 == cv::waitKey(1)){
+            cout << "It's time to QUIT !" << endl;
+            flagStop = true;
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    map<string, Packet> sidePackets;
+    if (useQos)
+        sidePackets["qos"] = MakePacket<shared_ptr<QosBoard>>(board);
+    MP_RETURN_IF_ERROR(graph.StartRun(sidePackets));
+
+    // Start the capture, it runs until Stop()
+    CaptureThread capture;
+    MP_RETURN_IF_ERROR(capture.Start(&graph, "in"));
+    while (!flagStop && !capture.IsDone())
+        this_thread::sleep_for(chrono::milliseconds(100));
+    Status status = capture.Stop();
+
+    // Close the input streams, Wait for the graph to finish
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return status;
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 6.6 : Graceful degradation under load" << endl;
+    bool useQos = !(argc > 1 && string(argv[1]) == "noqos");
+    mediapipe::Status status = run(useQos);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,10 @@
+#include "mediapipe/examples/first_steps/6_6/qos.h"
+
+//==============================================================================
+namespace mediapipe {
+    const char *QosBoard::LevelName(int l) {
+        static const char *names[kNumLevels] = {"FULL", "REDUCED", "MINIMAL"};
+        return (l >= 0 && l < kNumLevels) ? names[l] : "?";
+    }
+}
+//==============================================================================
@@ -0,0 +1,77 @@
+#pragma once
+// Quality of service (QoS) levels, shared by the controller and the participating calculators
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// The current QoS level, written by QosControllerCalculator, read by the participants
+    /// Level 0 = full quality, higher levels = cheaper settings, up to kNumLevels - 1
+    /// It is shared via the side packet QOS (std::shared_ptr<QosBoard>)
+    class QosBoard {
+    public:
+        static constexpr int kNumLevels = 3;
+
+        int Level() const { return level.load(std::memory_order_acquire); }
+
+        void SetLevel(int l) { level.store(l, std::memory_order_release); }
+
+        static const char *LevelName(int l);
+
+    private:
+        std::atomic_int level{0};
+    };
+
+    //==============================================================================
+    /// The opt-in interface for a calculator which can degrade gracefully
+    /// Inherit it together with CalculatorBase, declare the side packet QOS in GetContract()
+    /// with QosParticipant::DeclareQos(cc), call QosJoin() in Open() and QosPoll() at the start of Process()
+    /// Implement ApplyQosLevel(): switch to the settings of the level
+    /// ApplyQosLevel() is always called from our own Open()/Process(), so no locking is needed
+    /// Without the QOS side packet the calculator always runs at level 0
+    class QosParticipant {
+    public:
+        virtual ~QosParticipant() = default;
+
+        /// Declare the optional side packet QOS
+        static void DeclareQos(CalculatorContract *cc) {
+            if (cc->InputSidePackets().HasTag("QOS"))
+                cc->InputSidePackets().Tag("QOS").Set<std::shared_ptr<QosBoard>>();
+        }
+
+    protected:
+        /// Switch to the settings of level l
+        virtual void ApplyQosLevel(int l) = 0;
+
+        /// Get the board and apply the current level
+        void QosJoin(CalculatorContext *cc) {
+            if (cc->InputSidePackets().HasTag("QOS"))
+                board = cc->InputSidePackets().Tag("QOS").Get<std::shared_ptr<QosBoard>>();
+            qosLevel = board ? board->Level() : 0;
+            ApplyQosLevel(qosLevel);
+        }
+
+        /// One atomic load if the level did not change
+        void QosPoll() {
+            if (!board)
+                return;
+            int l = board->Level();
+            if (l != qosLevel) {
+                qosLevel = l;
+                ApplyQosLevel(l);
+            }
+        }
+
+        int qosLevel = 0;
+
+    private:
+        std::shared_ptr<QosBoard> board;
+    };
+}
+//==============================================================================
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <chrono>
+#include <memory>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/6_6/qos.h"
+#include "mediapipe/examples/first_steps/6_6/qos_controller_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Watches the load of the graph and sets the QoS level on the QosBoard (side packet QOS)
+    /// IN : the graph input stream, OUT : the graph output stream (a back edge)
+    /// Packet timestamps must be capture times in microseconds of the monotonic clock (CaptureThread, 5.4)
+    /// Depth = frames which entered the graph but did not leave it yet (they wait in the input queues)
+    /// Latency = now - timestamp at the output, as a moving average
+    /// Overload for degrade_after output frames in a row -> one level cheaper
+    /// Underload for restore_after output frames in a row -> one level better
+    /// The two thresholds and the two counters give hysteresis, so that the level does not flicker
+    /// Optional output LEVEL (int) : the level at each output frame
+    class QosControllerCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IN").SetAny();
+            cc->Inputs().Tag("OUT").SetAny();
+            cc->InputSidePackets().Tag("QOS").Set<std::shared_ptr<QosBoard>>();
+            if (cc->Outputs().HasTag("LEVEL"))
+                cc->Outputs().Tag("LEVEL").Set<int>();
+            // React to each input at once, as FlowLimiterCalculator does
+            cc->SetInputStreamHandler("ImmediateInputStreamHandler");
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<QosControllerCalculatorOptions>();
+            board = cc->InputSidePackets().Tag("QOS").Get<std::shared_ptr<QosBoard>>();
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            using namespace std;
+            if (!cc->Inputs().Tag("IN").IsEmpty())
+                numIn++;
+            const auto &out = cc->Inputs().Tag("OUT");
+            if (out.IsEmpty())
+                return OkStatus();
+            numOut++;
+
+            // Measure
+            int64 now = chrono::duration_cast<chrono::microseconds>(
+                    chrono::steady_clock::now().time_since_epoch()).count();
+            double latencyMs = (now - out.Value().Timestamp().Value()) / 1000.;
+            latencyAvgMs = numOut == 1 ? latencyMs :
+                           options.ewma_alpha() * latencyMs + (1 - options.ewma_alpha()) * latencyAvgMs;
+            int64 depth = numIn - numOut;
+
+            // Decide
+            bool over = latencyAvgMs > options.high_latency_ms() || depth > options.high_depth();
+            bool under = latencyAvgMs < options.low_latency_ms() && depth <= options.low_depth();
+            overCount = over ? overCount + 1 : 0;
+            underCount = under ? underCount + 1 : 0;
+            int level = board->Level();
+            int newLevel = level;
+            if (overCount >= options.degrade_after() && level < QosBoard::kNumLevels - 1)
+                newLevel = level + 1;
+            else if (underCount >= options.restore_after() && level > 0)
+                newLevel = level - 1;
+            if (newLevel != level) {
+                board->SetLevel(newLevel);
+                overCount = underCount = 0;
+                cout << "QosControllerCalculator : latency = " << latencyAvgMs << " ms, depth = " << depth
+                     << ", level " << QosBoard::LevelName(level) << " -> " << QosBoard::LevelName(newLevel) << endl;
+            }
+            if (cc->Outputs().HasTag("LEVEL"))
+                cc->Outputs().Tag("LEVEL").AddPacket(MakePacket<int>(newLevel).At(out.Value().Timestamp()));
+            return OkStatus();
+        }
+
+    private:
+        QosControllerCalculatorOptions options;
+        std::shared_ptr<QosBoard> board;
+        int64 numIn = 0, numOut = 0;
+        double latencyAvgMs = 0;
+        int overCount = 0, underCount = 0;
+    };
+    REGISTER_CALCULATOR(QosControllerCalculator);
+}
+//==============================================================================
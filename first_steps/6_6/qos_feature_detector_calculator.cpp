@@ -0,0 +1,71 @@
+#include <iostream>
+#include <algorithm>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_features2d_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/6_6/qos.h"
+#include "mediapipe/examples/first_steps/6_6/qos_feature_detector_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// ORB keypoints (as FeatureDetectorCalculator in 2.4) which takes part in QoS:
+    /// max_features and the number of ORB pyramid levels depend on the level
+    /// Defaults: 1000, 500, 200 features; 4, 3, 2 pyramid levels
+    class QosFeatureDetectorCalculator : public CalculatorBase, public QosParticipant {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            cc->Outputs().Tag("FEATURES").Set<std::vector<cv::KeyPoint>>();
+            DeclareQos(cc);
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<QosFeatureDetectorCalculatorOptions>();
+            if (options.max_features_size() == 0)
+                for (int n : {1000, 500, 200})
+                    options.add_max_features(n);
+            if (options.pyramid_levels_size() == 0)
+                for (int n : {4, 3, 2})
+                    options.add_pyramid_levels(n);
+            orb = cv::ORB::create();
+            QosJoin(cc);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            QosPoll();
+            cv::Mat img = formats::MatView(&cc->Inputs().Tag("IMAGE").Get<ImageFrame>());
+            cv::cvtColor(img, gray, cv::COLOR_RGB2GRAY);
+            std::vector<cv::KeyPoint> *kps = new std::vector<cv::KeyPoint>();
+            orb->detect(gray, *kps);
+            cc->Outputs().Tag("FEATURES").Add(kps, cc->InputTimestamp());
+            return OkStatus();
+        }
+
+    protected:
+        void ApplyQosLevel(int l) override {
+            using namespace std;
+            int nf = options.max_features(min(l, options.max_features_size() - 1));
+            int nl = options.pyramid_levels(min(l, options.pyramid_levels_size() - 1));
+            orb->setMaxFeatures(nf);
+            orb->setNLevels(nl);
+            cout << "QosFeatureDetectorCalculator : level " << QosBoard::LevelName(l) << " : max_features = "
+                 << nf << ", pyramid levels = " << nl << endl;
+        }
+
+    private:
+        QosFeatureDetectorCalculatorOptions options;
+        cv::Ptr<cv::ORB> orb;
+        cv::Mat gray;
+    };
+    REGISTER_CALCULATOR(QosFeatureDetectorCalculator);
+}
+//==============================================================================
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <algorithm>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/6_6/qos.h"
+#include "mediapipe/examples/first_steps/6_6/qos_scale_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// ScaleImageCalculator (2.2) which takes part in QoS: the target size and the algorithm depend on the level
+    /// Default levels: 1280x720 CUBIC, 960x540 LINEAR, 640x360 AREA
+    class QosScaleCalculator : public CalculatorBase, public QosParticipant {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            cc->Outputs().Tag("IMAGE").Set<ImageFrame>();
+            DeclareQos(cc);
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<QosScaleCalculatorOptions>();
+            if (options.level_size() == 0) {
+                addLevel(1280, 720, QosScaleCalculatorOptions::CUBIC);
+                addLevel(960, 540, QosScaleCalculatorOptions::LINEAR);
+                addLevel(640, 360, QosScaleCalculatorOptions::AREA);
+            }
+            QosJoin(cc);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            QosPoll();
+            const ImageFrame &inFrame = cc->Inputs().Tag("IMAGE").Get<ImageFrame>();
+            ImageFrame *oFrame = new ImageFrame(inFrame.Format(), width, height, ImageFrame::kDefaultAlignmentBoundary);
+            cv::Mat dst = formats::MatView(oFrame);
+            cv::resize(formats::MatView(&inFrame), dst, dst.size(), 0, 0, interpolation);
+            cc->Outputs().Tag("IMAGE").Add(oFrame, cc->InputTimestamp());
+            return OkStatus();
+        }
+
+    protected:
+        void ApplyQosLevel(int l) override {
+            using namespace std;
+            const auto &lev = options.level(min(l, options.level_size() - 1));
+            width = lev.target_width();
+            height = lev.target_height();
+            switch (lev.algorithm()) {
+                case QosScaleCalculatorOptions::CUBIC:
+                    interpolation = cv::INTER_CUBIC;
+                    break;
+                case QosScaleCalculatorOptions::LINEAR:
+                    interpolation = cv::INTER_LINEAR;
+                    break;
+                case QosScaleCalculatorOptions::AREA:
+                    interpolation = cv::INTER_AREA;
+                    break;
+            }
+            cout << "QosScaleCalculator : level " << QosBoard::LevelName(l) << " : " << width << "x" << height
+                 << ", " << QosScaleCalculatorOptions::Algorithm_Name(lev.algorithm()) << endl;
+        }
+
+    private:
+        void addLevel(int w, int h, QosScaleCalculatorOptions::Algorithm a) {
+            auto *lev = options.add_level();
+            lev->set_target_width(w);
+            lev->set_target_height(h);
+            lev->set_algorithm(a);
+        }
+
+        QosScaleCalculatorOptions options;
+        int width = 0, height = 0;
+        int interpolation = cv::INTER_CUBIC;
+    };
+    REGISTER_CALCULATOR(QosScaleCalculator);
+}
+//==============================================================================
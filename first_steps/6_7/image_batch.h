@@ -0,0 +1,14 @@
+#pragma once
+// A batch of image packets, each keeps its own timestamp
+
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Packets of ImageFrame in timestamp order, not copied: a packet is a reference-counted pointer
+    /// The batch packet itself has the timestamp of the last frame
+    using ImageBatch = std::vector<Packet>;
+}
+//==============================================================================
@@ -0,0 +1,130 @@
+/// Example 6.7 : Micro-batching
+/// By Oleksiy Grechnyev, IT-JIM
+/// A heavy node often pays a fixed cost per Process() call (e.g. a neural network run), and is much
+/// more efficient on batches. Here SlowBatchCalculator costs setup_ms per call + per_frame_ms per frame
+/// MicroBatchCalculator collects up to N frames, or waits at most T ms, and sends them as one ImageBatch,
+/// UnbatchCalculator splits the results back to single frames at their original timestamps
+/// With "nobatch" (N = 1) each frame pays the full setup cost: the graph cannot keep up with the camera,
+/// and the latency grows as in 3.1; with batches it keeps up, at the price of some added latency
+/// MicroBatchCalculator prints histograms of the batch size and of the added latency
+/// The camera runs on CaptureThread from 5.4, so that packet timestamps are capture times in microseconds
+/// Usage: 6_7 [batch|nobatch] [N=8] [T_ms=100]
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/5_4/capture_thread.h"
+
+//==============================================================================
+mediapipe::Status run(int maxBatch, double maxWaitMs) {
+    using namespace std;
+    using namespace mediapipe;
+
+    string protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "MicroBatchCalculator"
+            input_stream: "IMAGE:in"
+            output_stream: "BATCH:batch_in"
+            options: {
+                [mediapipe.MicroBatchCalculatorOptions.ext] {
+                    max_batch_size: )" + to_string(maxBatch) + R"(
+                    max_wait_ms: )" + to_string(maxWaitMs) + R"(
+                }
+            }
+        }
+        node {
+            calculator: "SlowBatchCalculator"
+            input_stream: "BATCH:batch_in"
+            output_stream: "BATCH:batch_out"
+            options: {
+                [mediapipe.SlowBatchCalculatorOptions.ext] {
+                    setup_ms: 60
+                    per_frame_ms: 5
+                }
+            }
+        }
+        node {
+            calculator: "UnbatchCalculator"
+            input_stream: "BATCH:batch_out"
+            output_stream: "IMAGE:out"
+        }
+        )";
+
+    // Parse config and create graph
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    atomic_bool flagStop(false);
+
+    // The observer displays the frame with the latency
+    auto cb = [&flagStop, maxBatch](const Packet &packet)->Status{
+        double latencyMs = (CaptureThread::NowUs() - packet.Timestamp().Value()) / 1000.;
+        const ImageFrame & outputFrame = packet.Get<ImageFrame>();
+        cv::Mat ofMat = formats::MatView(&outputFrame);
+        cv::Mat frameOut;
+        cvtColor(ofMat, frameOut, cv::COLOR_RGB2BGR);
+        string text = "N = " + to_string(maxBatch) + " latency " + to_string(int(latencyMs)) + " ms";
+        cv::putText(frameOut, text, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.8, cv::Scalar(0, 255, 0), 2);
+        cv::imshow("frameOut", frameOut);
+        if (27 == cv::waitKey(1)){
+            cout << "It's time to QUIT !" << endl;
+            flagStop = true;
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // Start the capture, it runs until Stop()
+    CaptureThread capture;
+    MP_RETURN_IF_ERROR(capture.Start(&graph, "in"));
+    while (!flagStop && !capture.IsDone())
+        this_thread::sleep_for(chrono::milliseconds(100));
+    Status status = capture.Stop();
+
+    // Close the input streams, Wait for the graph to finish
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return status;
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 6.7 : Micro-batching" << endl;
+    bool useBatch = !(argc > 1 && string(argv[1]) == "nobatch");
+    int maxBatch = argc > 2 ? stoi(argv[2]) : 8;
+    double maxWaitMs = argc > 3 ? stod(argv[3]) : 100;
+    if (!useBatch) {
+        maxBatch = 1;
+        maxWaitMs = 0;
+    }
+    mediapipe::Status status = run(maxBatch, maxWaitMs);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/6_7/image_batch.h"
+#include "mediapipe/examples/first_steps/6_7/micro_batch_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Collects ImageFrame packets into batches (ImageBatch) for a batch-capable calculator
+    /// A batch is sent when it has max_batch_size frames (N), or when its oldest frame
+    /// has waited max_wait_ms (T), and at Close()
+    /// Note: there are no timers in a calculator, the wait is checked when Process() is called,
+    /// i.e. on each new frame; if frames can stop coming, connect any stream of regular ticks to
+    /// the optional input TICK (it gets ImmediateInputStreamHandler), then the wait is at most T + tick period
+    /// The batch packet has the timestamp of its last frame, use UnbatchCalculator to get the frames
+    /// back at their original timestamps
+    /// Histograms of the batch size and of the added latency (time in the batch) are printed
+    class MicroBatchCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            if (cc->Inputs().HasTag("TICK")) {
+                cc->Inputs().Tag("TICK").SetAny();
+                cc->SetInputStreamHandler("ImmediateInputStreamHandler");
+            }
+            cc->Outputs().Tag("BATCH").Set<ImageBatch>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<MicroBatchCalculatorOptions>();
+            if (options.max_batch_size() < 1)
+                return absl::InvalidArgumentError("MicroBatchCalculator : max_batch_size must be >= 1");
+            maxWaitUs = int64(options.max_wait_ms() * 1000);
+            sizeHist.assign(options.max_batch_size() + 1, 0);
+            latencyHist.assign(10, 0);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            int64 now = nowUs();
+            if (!cc->Inputs().Tag("IMAGE").IsEmpty()) {
+                batch.push_back(cc->Inputs().Tag("IMAGE").Value());
+                arrivals.push_back(now);
+            }
+            if (!batch.empty() && (int(batch.size()) >= options.max_batch_size() || now - arrivals.front() >= maxWaitUs))
+                flush(cc, now);
+            return OkStatus();
+        }
+
+        Status Close(CalculatorContext *cc) override {
+            if (!batch.empty())
+                flush(cc, nowUs());
+            printStats();
+            return OkStatus();
+        }
+
+    private:
+        static int64 nowUs() {
+            using namespace std::chrono;
+            return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+
+        void flush(CalculatorContext *cc, int64 now) {
+            double bucketUs = std::max(options.latency_bucket_ms(), 0.001) * 1000;
+            for (int64 t : arrivals)
+                latencyHist[std::min<size_t>(size_t((now - t) / bucketUs), latencyHist.size() - 1)]++;
+            sizeHist[batch.size()]++;
+            Timestamp ts = batch.back().Timestamp();
+            cc->Outputs().Tag("BATCH").Add(new ImageBatch(std::move(batch)), ts);
+            batch.clear();
+            arrivals.clear();
+            numBatches++;
+            if (options.stats_every() > 0 && numBatches % options.stats_every() == 0)
+                printStats();
+        }
+
+        void printStats() const {
+            using namespace std;
+            cout << "MicroBatchCalculator : " << numBatches << " batches" << endl << "  batch size :";
+            for (size_t i = 1; i < sizeHist.size(); ++i)
+                cout << " " << i << ":" << sizeHist[i];
+            cout << endl << "  added latency, ms :";
+            for (size_t i = 0; i < latencyHist.size(); ++i) {
+                double b = options.latency_bucket_ms();
+                cout << " [" << i * b << ", ";
+                if (i + 1 < latencyHist.size())
+                    cout << (i + 1) * b;
+                else
+                    cout << "inf";
+                cout << "):" << latencyHist[i];
+            }
+            cout << endl;
+        }
+
+        MicroBatchCalculatorOptions options;
+        int64 maxWaitUs = 0;
+        ImageBatch batch;
+        std::vector<int64> arrivals;   /// Arrival times of the batch frames, microseconds
+        int64 numBatches = 0;
+        std::vector<int64> sizeHist, latencyHist;
+    };
+    REGISTER_CALCULATOR(MicroBatchCalculator);
+}
+//==============================================================================
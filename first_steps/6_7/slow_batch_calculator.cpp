@@ -0,0 +1,60 @@
+#include <chrono>
+#include <thread>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+
+#include "mediapipe/examples/first_steps/6_7/image_batch.h"
+#include "mediapipe/examples/first_steps/6_7/slow_batch_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// SlowCalculator of 3.1 for batches: applies photo-negative to the central 1/9 of each image
+    /// The delay models a model runner: setup_ms per Process() call + per_frame_ms per frame,
+    /// so a batch of N frames costs much less than N calls with one frame
+    /// Input and output: BATCH (ImageBatch), the output frames have the timestamps of the input ones
+    class SlowBatchCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("BATCH").Set<ImageBatch>();
+            cc->Outputs().Tag("BATCH").Set<ImageBatch>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<SlowBatchCalculatorOptions>();
+            cc->SetOffset(0);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            using namespace std;
+            const ImageBatch &batchIn = cc->Inputs().Tag("BATCH").Get<ImageBatch>();
+            ImageBatch *batchOut = new ImageBatch;
+            batchOut->reserve(batchIn.size());
+            for (const Packet &p : batchIn) {
+                ImageFrame *iFrame = new ImageFrame();
+                iFrame->CopyFrom(p.Get<ImageFrame>(), 1);
+                cv::Mat img = formats::MatView(iFrame);
+                int nc = img.cols / 3, nr = img.rows / 3;
+                cv::Mat m(img, cv::Rect(nc, nr, nc, nr));
+                cv::bitwise_not(m, m);
+                batchOut->push_back(Adopt(iFrame).At(p.Timestamp()));
+            }
+            // Slow down artificially
+            double ms = options.setup_ms() + options.per_frame_ms() * batchIn.size();
+            this_thread::sleep_for(chrono::microseconds(int64(ms * 1000)));
+            cc->Outputs().Tag("BATCH").Add(batchOut, cc->InputTimestamp());
+            return OkStatus();
+        }
+
+    private:
+        SlowBatchCalculatorOptions options;
+    };
+    REGISTER_CALCULATOR(SlowBatchCalculator);
+}
+//==============================================================================
@@ -0,0 +1,28 @@
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/6_7/image_batch.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Splits an ImageBatch into single frames, each at its original timestamp
+    /// These are earlier than the batch timestamp, this is allowed because we do not call SetOffset():
+    /// output timestamps only have to grow, and batches come in order
+    class UnbatchCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("BATCH").Set<ImageBatch>();
+            cc->Outputs().Tag("IMAGE").Set<ImageFrame>();
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            for (const Packet &p : cc->Inputs().Tag("BATCH").Get<ImageBatch>())
+                cc->Outputs().Tag("IMAGE").AddPacket(p);
+            return OkStatus();
+        }
+    };
+    REGISTER_CALCULATOR(UnbatchCalculator);
+}
+//==============================================================================
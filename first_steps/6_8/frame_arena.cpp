@@ -0,0 +1,147 @@
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "mediapipe/examples/first_steps/6_8/frame_arena.h"
+
+//==============================================================================
+namespace mediapipe {
+    namespace {
+        constexpr uint64 kHugePage = 2ull << 20;
+        constexpr uint64 kPage = 4096;
+
+        uint64 roundUp(uint64 n, uint64 a) {
+            return (n + a - 1) / a * a;
+        }
+
+        /// Size class: whole pages up to 64 KB, then 4 classes per power of two (at most 25% waste)
+        uint64 classSize(uint64 n) {
+            n = roundUp(std::max<uint64>(n, 1), kPage);
+            if (n <= 16 * kPage)
+                return n;
+            uint64 p = uint64(1) << (63 - __builtin_clzll(n));
+            return roundUp(n, p / 4);
+        }
+    }
+
+    //==============================================================================
+    std::shared_ptr<FrameArena> FrameArena::Create(const FrameArenaOptions &options) {
+        return std::shared_ptr<FrameArena>(new FrameArena(options));
+    }
+
+    //==============================================================================
+    FrameArena::~FrameArena() {
+        // Frames hold a shared_ptr to us, so no block is in use here
+        for (const Chunk &c : chunks)
+            munmap(c.data, c.size);
+    }
+
+    //==============================================================================
+    bool FrameArena::addChunk(uint64 size) {
+        size = roundUp(std::max(size, options.chunkBytes), kHugePage);
+        if (options.maxBytes > 0 && stats.bytesMapped + size > options.maxBytes)
+            return false;
+        void *p = MAP_FAILED;
+        if (options.hugePages) {
+            p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED)
+                stats.hugetlb = true;
+        }
+        if (p == MAP_FAILED) {
+            // No reserved huge pages: map 2 MB more and cut to a 2 MB boundary, so that
+            // transparent huge pages can back the whole chunk
+            void *raw = mmap(nullptr, size + kHugePage, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED)
+                return false;
+            uintptr_t begin = uintptr_t(raw), aligned = roundUp(begin, kHugePage);
+            if (aligned > begin)
+                munmap(raw, aligned - begin);
+            if (aligned + size < begin + size + kHugePage)
+                munmap(reinterpret_cast<void *>(aligned + size), begin + size + kHugePage - aligned - size);
+            p = reinterpret_cast<void *>(aligned);
+            if (options.hugePages && madvise(p, size, MADV_HUGEPAGE) == 0)
+                stats.thp = true;
+        }
+        // NUMA placement must be set before the pages are touched
+        if (options.numaNode >= 0 && options.numaNode < 64) {
+            unsigned long mask = 1ul << options.numaNode;
+            syscall(SYS_mbind, p, size, MPOL_BIND, &mask, 64, 0);
+        }
+        if (options.prefault) {
+            uint8 *data = static_cast<uint8 *>(p);
+            for (uint64 i = 0; i < size; i += kPage)
+                data[i] = 0;
+        }
+        chunks.push_back(Chunk{static_cast<uint8 *>(p), size});
+        bumpPtr = static_cast<uint8 *>(p);
+        bumpEnd = bumpPtr + size;
+        stats.bytesMapped += size;
+        stats.chunks++;
+        return true;
+    }
+
+    //==============================================================================
+    uint8 *FrameArena::allocate(uint64 size, uint64 *classBytes) {
+        std::lock_guard<std::mutex> lock(mutexArena);
+        uint64 cs = classSize(size);
+        *classBytes = cs;
+        stats.allocations++;
+        uint8 *p = nullptr;
+        std::vector<uint8 *> &freeList = freeLists[cs];
+        if (!freeList.empty()) {
+            p = freeList.back();
+            freeList.pop_back();
+            stats.recycled++;
+        } else {
+            // The tail of the last chunk is wasted if the block does not fit
+            if (uint64(bumpEnd - bumpPtr) < cs && !addChunk(cs)) {
+                stats.fallbacks++;
+                return nullptr;
+            }
+            p = bumpPtr;
+            bumpPtr += cs;
+        }
+        stats.bytesInUse += cs;
+        stats.peakBytesInUse = std::max(stats.peakBytesInUse, stats.bytesInUse);
+        return p;
+    }
+
+    //==============================================================================
+    void FrameArena::release(uint8 *p, uint64 classBytes, bool fallback) {
+        if (fallback) {
+            std::free(p);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutexArena);
+        freeLists[classBytes].push_back(p);
+        stats.bytesInUse -= classBytes;
+    }
+
+    //==============================================================================
+    std::unique_ptr<ImageFrame> FrameArena::NewFrame(ImageFormat::Format format, int width, int height,
+                                                     int alignmentBoundary) {
+        int rowBytes = width * ImageFrame::NumberOfChannelsForFormat(format) * ImageFrame::ByteDepthForFormat(format);
+        int widthStep = int(roundUp(rowBytes, alignmentBoundary));
+        uint64 size = uint64(widthStep) * height;
+        uint64 classBytes = 0;
+        uint8 *pixels = allocate(size, &classBytes);
+        bool fallback = pixels == nullptr;
+        if (fallback)
+            pixels = static_cast<uint8 *>(std::aligned_alloc(kPage, roundUp(size, kPage)));
+        std::shared_ptr<FrameArena> self = shared_from_this();
+        return std::unique_ptr<ImageFrame>(new ImageFrame(
+                format, width, height, widthStep, pixels,
+                [self, classBytes, fallback](uint8 *p) { self->release(p, classBytes, fallback); }));
+    }
+
+    //==============================================================================
+    FrameArenaStats FrameArena::GetStats() const {
+        std::lock_guard<std::mutex> lock(mutexArena);
+        return stats;
+    }
+}
+//==============================================================================
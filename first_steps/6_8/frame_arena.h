@@ -0,0 +1,82 @@
+#pragma once
+// Huge-page arena for ImageFrame pixels, with size-class recycling and optional NUMA placement
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/integral_types.h"
+
+//==============================================================================
+namespace mediapipe {
+    struct FrameArenaOptions {
+        /// Memory is mapped in chunks of this size (rounded up to 2 MB), more chunks are added when needed
+        uint64 chunkBytes = 256ull << 20;
+        /// Stop mapping new chunks above this, and use the usual allocator instead, 0 = no limit
+        uint64 maxBytes = 0;
+        /// Try MAP_HUGETLB (needs reserved huge pages: sysctl vm.nr_hugepages), then transparent huge pages
+        bool hugePages = true;
+        /// Bind the chunks to this NUMA node (mbind), -1 = no binding
+        int numaNode = -1;
+        /// Touch all pages when a chunk is mapped, so that no frame ever takes a page fault
+        bool prefault = true;
+    };
+
+    struct FrameArenaStats {
+        uint64 bytesMapped = 0;       /// All chunks
+        uint64 bytesInUse = 0;        /// Blocks given to frames now (size class sizes)
+        uint64 peakBytesInUse = 0;
+        uint64 chunks = 0;
+        uint64 allocations = 0;       /// Blocks given to frames
+        uint64 recycled = 0;          /// ... of them taken from the free lists
+        uint64 fallbacks = 0;         /// ... of them allocated by the usual allocator (maxBytes reached)
+        bool hugetlb = false;         /// MAP_HUGETLB worked
+        bool thp = false;             /// madvise(MADV_HUGEPAGE) worked (if no MAP_HUGETLB)
+    };
+
+    /// An opt-in allocator for ImageFrame pixel buffers
+    /// With the usual allocator, each big frame (24 MB for 4K RGB) is a fresh mmap() or a piece of the heap,
+    /// its first touch costs thousands of page faults (one per 4 KB page), and it is spread over many TLB entries
+    /// The arena maps big 2 MB-aligned chunks (huge pages if possible), prefaults them once,
+    /// and carves frames out of them; a freed frame goes to the free list of its size class
+    /// (4 classes per power of two) and is reused by the next frame of a similar size, it is never unmapped
+    /// Thread-safe; frames keep the arena alive (their deleters hold a shared_ptr), so create it with Create()
+    class FrameArena : public std::enable_shared_from_this<FrameArena> {
+    public:
+        static std::shared_ptr<FrameArena> Create(const FrameArenaOptions &options = FrameArenaOptions());
+
+        ~FrameArena();
+
+        /// A new frame with the pixels in the arena, widthStep aligned to alignmentBoundary as in ImageFrame
+        std::unique_ptr<ImageFrame> NewFrame(ImageFormat::Format format, int width, int height,
+                                             int alignmentBoundary = ImageFrame::kDefaultAlignmentBoundary);
+
+        FrameArenaStats GetStats() const;
+
+    private:
+        explicit FrameArena(const FrameArenaOptions &options) : options(options) {}
+
+        /// A block of at least size bytes, its class size is returned in classBytes
+        uint8 *allocate(uint64 size, uint64 *classBytes);
+
+        void release(uint8 *p, uint64 classBytes, bool fallback);
+
+        /// Map a new chunk of at least size bytes, false if not possible
+        bool addChunk(uint64 size);
+
+        struct Chunk {
+            uint8 *data;
+            uint64 size;
+        };
+
+        FrameArenaOptions options;
+        mutable std::mutex mutexArena;
+        std::vector<Chunk> chunks;
+        uint8 *bumpPtr = nullptr, *bumpEnd = nullptr;   /// Free space of the last chunk
+        std::map<uint64, std::vector<uint8 *>> freeLists;   /// Class size -> free blocks
+        FrameArenaStats stats;
+    };
+}
+//==============================================================================
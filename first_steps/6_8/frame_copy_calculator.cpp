@@ -0,0 +1,53 @@
+#include <cstring>
+#include <memory>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/6_8/frame_arena.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Copies the input frame to a new frame, as any calculator which creates a new output image
+    /// With the optional side packet ARENA (shared_ptr<FrameArena>) the new frame comes from the arena,
+    /// without it from the usual allocator (as ImageFrame::CopyFrom() does), this is how calculators opt in
+    class FrameCopyCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            cc->Outputs().Tag("IMAGE").Set<ImageFrame>();
+            if (cc->InputSidePackets().HasTag("ARENA"))
+                cc->InputSidePackets().Tag("ARENA").Set<std::shared_ptr<FrameArena>>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            if (cc->InputSidePackets().HasTag("ARENA"))
+                arena = cc->InputSidePackets().Tag("ARENA").Get<std::shared_ptr<FrameArena>>();
+            cc->SetOffset(0);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            const ImageFrame &in = cc->Inputs().Tag("IMAGE").Get<ImageFrame>();
+            std::unique_ptr<ImageFrame> out;
+            if (arena)
+                out = arena->NewFrame(in.Format(), in.Width(), in.Height());
+            else
+                out.reset(new ImageFrame(in.Format(), in.Width(), in.Height(), ImageFrame::kDefaultAlignmentBoundary));
+            // Row by row, the steps can differ
+            int rowBytes = in.Width() * in.NumberOfChannels() * in.ByteDepth();
+            for (int y = 0; y < in.Height(); ++y)
+                std::memcpy(out->MutablePixelData() + y * out->WidthStep(), in.PixelData() + y * in.WidthStep(),
+                            rowBytes);
+            cc->Outputs().Tag("IMAGE").Add(out.release(), cc->InputTimestamp());
+            return OkStatus();
+        }
+
+    private:
+        std::shared_ptr<FrameArena> arena;
+    };
+    REGISTER_CALCULATOR(FrameCopyCalculator);
+}
+//==============================================================================
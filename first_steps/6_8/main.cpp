@@ -0,0 +1,151 @@
+/// Example 6.8 : Huge-page frame arena
+/// By Oleksiy Grechnyev, IT-JIM
+/// All our video examples allocate every frame with new ImageFrame(..., kDefaultAlignmentBoundary),
+/// i.e. with the usual allocator. A 4K RGB frame is 24 MB: a fresh allocation of it is 6000 page faults
+/// on the first touch, and 6000 TLB entries of 4 KB pages
+/// FrameArena (frame_arena.h) is an opt-in allocator for ImageFrame pixels: it maps 2 MB-aligned chunks
+/// (MAP_HUGETLB, or transparent huge pages), optionally binds them to a NUMA node, prefaults them once,
+/// and recycles freed frames by size class
+/// The benchmark: the ingest loop creates and fills frames (as the camera loop does),
+/// FrameCopyCalculator copies each one into a new frame (as most image calculators do),
+/// at most in_flight frames are in the graph at a time
+/// We run it with the usual allocator, then with the arena (side packet ARENA, and NewFrame() in the loop),
+/// and print the time, copy bandwidth, minor page faults and the arena statistics
+/// For MAP_HUGETLB reserve huge pages first, e.g.: sudo sysctl vm.nr_hugepages=512
+/// Usage: 6_8 [width=3840] [height=2160] [frames=300] [in_flight=4] [numa_node=-1]
+
+#include <sys/resource.h>
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <map>
+#include <cstring>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/examples/first_steps/6_8/frame_arena.h"
+
+//==============================================================================
+/// Minor page faults of the process so far
+long minorFaults() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+//==============================================================================
+mediapipe::Status benchmark(bool useArena, int width, int height, int numFrames, int inFlight, int numaNode) {
+    using namespace std;
+    using namespace mediapipe;
+
+    string sideArena = useArena ? R"(input_side_packet: "ARENA:arena")" : "";
+    string protoG = R"(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+            calculator: "FrameCopyCalculator"
+            input_stream: "IMAGE:in"
+            output_stream: "IMAGE:out"
+            )" + sideArena + R"(
+        }
+        )";
+    if (useArena)
+        protoG += R"(input_side_packet: "arena")";
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    // The observer only releases the in-flight slot, the frame is freed right after
+    atomic_int numInFlight(0);
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", [&numInFlight](const Packet &packet)->Status{
+        numInFlight--;
+        return OkStatus();
+    }));
+
+    shared_ptr<FrameArena> arena;
+    map<string, Packet> sidePackets;
+    if (useArena) {
+        FrameArenaOptions options;
+        // Enough for all frames in flight: in the loop, in the graph, and the copies
+        options.chunkBytes = uint64(2 * inFlight + 4) * width * height * 3;
+        options.numaNode = numaNode;
+        arena = FrameArena::Create(options);
+        sidePackets["arena"] = MakePacket<shared_ptr<FrameArena>>(arena);
+    }
+    MP_RETURN_IF_ERROR(graph.StartRun(sidePackets));
+
+    // The source image, as if from a camera
+    vector<uint8> source(size_t(width) * 3 * height);
+    for (size_t i = 0; i < source.size(); ++i)
+        source[i] = uint8(i * 7);
+
+    long faults0 = minorFaults();
+    auto t1 = chrono::steady_clock::now();
+    for (int i = 0; i < numFrames; ++i) {
+        while (numInFlight >= inFlight)
+            this_thread::yield();
+        unique_ptr<ImageFrame> frame;
+        if (useArena)
+            frame = arena->NewFrame(ImageFormat::SRGB, width, height);
+        else
+            frame.reset(new ImageFrame(ImageFormat::SRGB, width, height, ImageFrame::kDefaultAlignmentBoundary));
+        for (int y = 0; y < height; ++y)
+            memcpy(frame->MutablePixelData() + y * frame->WidthStep(), source.data() + size_t(y) * width * 3,
+                   width * 3);
+        numInFlight++;
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", Adopt(frame.release()).At(Timestamp(i))));
+    }
+    graph.CloseInputStream("in");
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    auto t2 = chrono::steady_clock::now();
+    long faults = minorFaults() - faults0;
+
+    // Each frame is written twice: filled in the loop, copied in the graph
+    double sec = chrono::duration<double>(t2 - t1).count();
+    double gb = 2.0 * numFrames * width * 3 * height / 1e9;
+    cout << (useArena ? "ARENA" : "DEFAULT") << " : " << numFrames << " frames " << width << "x" << height
+         << " in " << sec << " s, " << numFrames / sec << " FPS, " << gb / sec << " GB/s written, "
+         << faults << " minor page faults (" << double(faults) / numFrames << " per frame)" << endl;
+    if (useArena) {
+        FrameArenaStats s = arena->GetStats();
+        cout << "    arena : mapped = " << s.bytesMapped / (1 << 20) << " MB in " << s.chunks << " chunks, peak use = "
+             << s.peakBytesInUse / (1 << 20) << " MB, allocations = " << s.allocations << ", recycled = "
+             << s.recycled << ", fallbacks = " << s.fallbacks << ", hugetlb = " << s.hugetlb << ", thp = " << s.thp
+             << endl;
+    }
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 6.8 : Huge-page frame arena" << endl;
+    int width = argc > 1 ? stoi(argv[1]) : 3840;
+    int height = argc > 2 ? stoi(argv[2]) : 2160;
+    int numFrames = argc > 3 ? stoi(argv[3]) : 300;
+    int inFlight = argc > 4 ? stoi(argv[4]) : 4;
+    int numaNode = argc > 5 ? stoi(argv[5]) : -1;
+
+    mediapipe::Status status = benchmark(false, width, height, numFrames, inFlight, numaNode);
+    if (status.ok())
+        status = benchmark(true, width, height, numFrames, inFlight, numaNode);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
@@ -0,0 +1,177 @@
+/// Example 6.9 : Multi-ROI cropping
+/// By Oleksiy Grechnyev, IT-JIM
+/// ImageCroppingCalculator (2.3) takes one Rect per frame: for many regions per frame (detections, tiles)
+/// we would need one node or one packet per region
+/// Here MultiCropCalculator takes a std::vector<Rect> per frame and crops all of them in one node:
+/// "crops" : std::vector<ImageFrame> of the original sizes, one pass over the source rows
+/// "batch" : all crops resized to SIZE x SIZE in one contiguous ImageFrame (crops stacked vertically),
+///           as a batched neural network wants it
+/// The regions are a 4x3 grid of tiles + 4 moving boxes, which sometimes go outside the frame (black there)
+/// We display all crops as a mosaic, MultiCropCalculator prints the time per frame
+/// Usage: 6_9 [crops|batch] [SIZE=128]
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <vector>
+#include <cmath>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_highgui_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/port/opencv_video_inc.h"
+
+//==============================================================================
+/// Regions for frame i: a 4x3 grid of tiles + 4 moving boxes
+std::vector<mediapipe::Rect> makeRects(int i, int width, int height) {
+    using namespace std;
+    vector<mediapipe::Rect> rects;
+    int tw = width / 4, th = height / 3;
+    for (int y = 0; y < 3; ++y)
+        for (int x = 0; x < 4; ++x) {
+            mediapipe::Rect r;
+            r.set_x_center(x * tw + tw / 2);
+            r.set_y_center(y * th + th / 2);
+            r.set_width(tw);
+            r.set_height(th);
+            rects.push_back(r);
+        }
+    for (int k = 0; k < 4; ++k) {
+        double phase = 0.05 * i + k * M_PI / 2;
+        mediapipe::Rect r;
+        r.set_x_center(int(width * (0.5 + 0.55 * cos(phase))));
+        r.set_y_center(int(height * (0.5 + 0.55 * sin(1.3 * phase))));
+        r.set_width(width / 5);
+        r.set_height(height / 5);
+        rects.push_back(r);
+    }
+    return rects;
+}
+
+//==============================================================================
+/// All crops as one mosaic, each crop in a size x size cell
+cv::Mat makeMosaic(const std::vector<cv::Mat> &crops, int size) {
+    const int cols = 4;
+    int rows = (int(crops.size()) + cols - 1) / cols;
+    cv::Mat mosaic(std::max(rows, 1) * size, cols * size, CV_8UC3, cv::Scalar(64, 64, 64));
+    for (size_t i = 0; i < crops.size(); ++i) {
+        cv::Mat cell = mosaic(cv::Rect(int(i % cols) * size, int(i / cols) * size, size, size));
+        cv::resize(crops[i], cell, cell.size());
+    }
+    return mosaic;
+}
+
+//==============================================================================
+mediapipe::Status run(bool useBatch, int size) {
+    using namespace std;
+    using namespace mediapipe;
+
+    // With output_width/height MultiCropCalculator outputs BATCH, otherwise CROPS
+    string protoG = R"(
+        input_stream: "in"
+        input_stream: "in_rects"
+        output_stream: "out"
+        node {
+            calculator: "MultiCropCalculator"
+            input_stream: "IMAGE:in"
+            input_stream: "RECTS:in_rects"
+            output_stream: ")" + string(useBatch ? "BATCH" : "CROPS") + R"(:out"
+            options: {
+                [mediapipe.MultiCropCalculatorOptions.ext] {
+                    output_width: )" + to_string(useBatch ? size : 0) + R"(
+                    output_height: )" + to_string(useBatch ? size : 0) + R"(
+                }
+            }
+        }
+        )";
+
+    // Parse config and create graph
+    CalculatorGraphConfig config;
+    if (!ParseTextProto<mediapipe::CalculatorGraphConfig>(protoG, &config)) {
+        return absl::InternalError("Cannot parse the graph config !");
+    }
+    CalculatorGraph graph;
+    MP_RETURN_IF_ERROR(graph.Initialize(config));
+
+    atomic_bool flagStop(false);
+
+    // The observer splits the output into the crops and displays them
+    auto cb = [&flagStop, useBatch, size](const Packet &packet)->Status{
+        vector<cv::Mat> crops;
+        if (useBatch) {
+            // Crop i is rows [i*size, (i+1)*size) of the batch
+            const ImageFrame &batch = packet.Get<ImageFrame>();
+            cv::Mat batchMat = formats::MatView(&batch);
+            for (int y = 0; y + size <= batchMat.rows; y += size)
+                crops.push_back(batchMat(cv::Rect(0, y, size, size)));
+        } else {
+            for (const ImageFrame &crop : packet.Get<vector<ImageFrame>>())
+                crops.push_back(formats::MatView(&crop));
+        }
+        cv::Mat frameOut;
+        cvtColor(makeMosaic(crops, size), frameOut, cv::COLOR_RGB2BGR);
+        cv::imshow("frameOut", frameOut);
+        if (27 == cv::waitKey(1)){
+            cout << "It's time to QUIT !" << endl;
+            flagStop = true;
+        }
+        return OkStatus();
+    };
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream("out", cb));
+    MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+    // Start the camera and check that it works
+    cv::VideoCapture cap(cv::CAP_ANY);
+    if (!cap.isOpened())
+        return absl::NotFoundError("CANNOT OPEN CAMERA !");
+    cv::Mat frameIn, frameInRGB;
+
+    // Camera loop, runs until we get flagStop == true
+    for (int i=0; !flagStop ; ++i){
+        // Read next frame from camera
+        cap.read(frameIn);
+        if (frameIn.empty())
+            return absl::NotFoundError("CANNOT OPEN CAMERA !");
+
+        // Convert it to a packet and send, together with all regions for this frame
+        cv::cvtColor(frameIn, frameInRGB, cv::COLOR_BGR2RGB);
+        ImageFrame *inputFrame =  new ImageFrame(
+            ImageFormat::SRGB, frameInRGB.cols, frameInRGB.rows, ImageFrame::kDefaultAlignmentBoundary
+        );
+        frameInRGB.copyTo(formats::MatView(inputFrame));
+        Timestamp ts(i);
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in", Adopt(inputFrame).At(ts)));
+        MP_RETURN_IF_ERROR(graph.AddPacketToInputStream("in_rects",
+            MakePacket<vector<Rect>>(makeRects(i, frameIn.cols, frameIn.rows)).At(ts)));
+    }
+    // Don't forget to close both input streams !
+    graph.CloseInputStream("in");
+    graph.CloseInputStream("in_rects");
+    // Wait for the graph to finish
+    MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+    return OkStatus();
+}
+
+//==============================================================================
+int main(int argc, char** argv){
+    using namespace std;
+
+    FLAGS_alsologtostderr = 1;
+    google::SetLogDestination(google::GLOG_INFO, ".");
+    google::InitGoogleLogging(argv[0]);
+
+    cout << "Example 6.9 : Multi-ROI cropping" << endl;
+    bool useBatch = argc > 1 && string(argv[1]) == "batch";
+    int size = argc > 2 ? stoi(argv[2]) : 128;
+    mediapipe::Status status = run(useBatch, size);
+    cout << "status =" << status << endl;
+    cout << "status.ok() = " << status.ok() << endl;
+    return 0;
+}
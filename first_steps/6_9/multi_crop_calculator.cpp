@@ -0,0 +1,168 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+
+#include "mediapipe/examples/first_steps/6_9/multi_crop_calculator.pb.h"
+
+//==============================================================================
+namespace mediapipe {
+    /// Crops many regions of one frame in one node, instead of one ImageCroppingCalculator (2.3) per region
+    /// Inputs: IMAGE (ImageFrame), RECTS (std::vector<Rect>, pixels, center + size as in 2.3, no rotation)
+    /// Parts of a region outside the image are black
+    /// Outputs:
+    /// CROPS (std::vector<ImageFrame>): crops of their own sizes, made in ONE pass over the source rows:
+    ///     each source row is read once and copied to all crops which contain it,
+    ///     the rows are split into bands processed in parallel (cv::parallel_for_)
+    /// BATCH (ImageFrame): with output_width/height, all crops resized to this size and stacked vertically
+    ///     into one contiguous buffer (no row padding), crop i = rows [i*output_height, (i+1)*output_height),
+    ///     ready for a batched model; the regions are resized in parallel straight from the source,
+    ///     with no intermediate crops
+    class MultiCropCalculator : public CalculatorBase {
+    public:
+        static Status GetContract(CalculatorContract *cc) {
+            cc->Inputs().Tag("IMAGE").Set<ImageFrame>();
+            cc->Inputs().Tag("RECTS").Set<std::vector<Rect>>();
+            if (cc->Outputs().HasTag("CROPS"))
+                cc->Outputs().Tag("CROPS").Set<std::vector<ImageFrame>>();
+            if (cc->Outputs().HasTag("BATCH"))
+                cc->Outputs().Tag("BATCH").Set<ImageFrame>();
+            return OkStatus();
+        }
+
+        Status Open(CalculatorContext *cc) override {
+            options = cc->Options<MultiCropCalculatorOptions>();
+            bool resize = options.output_width() > 0 && options.output_height() > 0;
+            if (resize && !cc->Outputs().HasTag("BATCH"))
+                return absl::InvalidArgumentError("MultiCropCalculator : output_width/height need the output BATCH");
+            if (!resize && !cc->Outputs().HasTag("CROPS"))
+                return absl::InvalidArgumentError("MultiCropCalculator : without output_width/height use CROPS");
+            cc->SetOffset(0);
+            return OkStatus();
+        }
+
+        Status Process(CalculatorContext *cc) override {
+            using namespace std;
+            auto t1 = chrono::steady_clock::now();
+            const ImageFrame &src = cc->Inputs().Tag("IMAGE").Get<ImageFrame>();
+            const vector<Rect> &rects = cc->Inputs().Tag("RECTS").Get<vector<Rect>>();
+            // Top-left corners and sizes in pixels
+            vector<cv::Rect> boxes;
+            boxes.reserve(rects.size());
+            for (const Rect &r : rects)
+                boxes.emplace_back(r.x_center() - r.width() / 2, r.y_center() - r.height() / 2,
+                                   max(r.width(), 1), max(r.height(), 1));
+            if (options.output_width() > 0 && options.output_height() > 0)
+                cc->Outputs().Tag("BATCH").Add(cropResize(src, boxes).release(), cc->InputTimestamp());
+            else
+                cc->Outputs().Tag("CROPS").Add(crop(src, boxes).release(), cc->InputTimestamp());
+
+            totalSec += chrono::duration<double>(chrono::steady_clock::now() - t1).count();
+            numFrames++;
+            numCrops += boxes.size();
+            if (options.stats_every() > 0 && numFrames % options.stats_every() == 0)
+                printStats();
+            return OkStatus();
+        }
+
+        Status Close(CalculatorContext *cc) override {
+            printStats();
+            return OkStatus();
+        }
+
+    private:
+        /// Crops of their own sizes, one pass over the source rows
+        std::unique_ptr<std::vector<ImageFrame>> crop(const ImageFrame &src, const std::vector<cv::Rect> &boxes) {
+            using namespace std;
+            int pixelBytes = src.NumberOfChannels() * src.ByteDepth();
+            unique_ptr<vector<ImageFrame>> crops(new vector<ImageFrame>());
+            crops->reserve(boxes.size());
+            for (const cv::Rect &b : boxes) {
+                crops->emplace_back(src.Format(), b.width, b.height, ImageFrame::kDefaultAlignmentBoundary);
+                // Black where the region is outside the image
+                if (b.x < 0 || b.y < 0 || b.x + b.width > src.Width() || b.y + b.height > src.Height())
+                    crops->back().SetToZero();
+            }
+            // Only the source rows covered by some region
+            int yMin = src.Height(), yMax = 0;
+            for (const cv::Rect &b : boxes) {
+                yMin = min(yMin, max(b.y, 0));
+                yMax = max(yMax, min(b.y + b.height, src.Height()));
+            }
+            if (yMin >= yMax)
+                return crops;
+            vector<ImageFrame> &c = *crops;
+            cv::parallel_for_(cv::Range(yMin, yMax), [&](const cv::Range &range) {
+                for (int y = range.start; y < range.end; ++y) {
+                    const uint8 *srcRow = src.PixelData() + size_t(y) * src.WidthStep();
+                    for (size_t i = 0; i < boxes.size(); ++i) {
+                        const cv::Rect &b = boxes[i];
+                        if (y < b.y || y >= b.y + b.height)
+                            continue;
+                        int x0 = max(b.x, 0), x1 = min(b.x + b.width, src.Width());
+                        if (x0 >= x1)
+                            continue;
+                        uint8 *dstRow = c[i].MutablePixelData() + size_t(y - b.y) * c[i].WidthStep();
+                        memcpy(dstRow + (x0 - b.x) * pixelBytes, srcRow + x0 * pixelBytes, (x1 - x0) * pixelBytes);
+                    }
+                }
+            });
+            return crops;
+        }
+
+        /// All crops resized into one contiguous buffer
+        std::unique_ptr<ImageFrame> cropResize(const ImageFrame &src, const std::vector<cv::Rect> &boxes) {
+            using namespace std;
+            int w = options.output_width(), h = options.output_height();
+            int n = int(boxes.size());
+            // Alignment 1: no padding, the batch is one contiguous block of n * h * w pixels
+            unique_ptr<ImageFrame> batch(new ImageFrame(src.Format(), w, h * max(n, 1), 1));
+            batch->SetToZero();
+            cv::Mat srcMat = formats::MatView(&src);
+            cv::Mat batchMat = formats::MatView(batch.get());
+            cv::Rect whole(0, 0, src.Width(), src.Height());
+            cv::parallel_for_(cv::Range(0, n), [&](const cv::Range &range) {
+                for (int i = range.start; i < range.end; ++i) {
+                    const cv::Rect &b = boxes[i];
+                    cv::Rect inside = b & whole;
+                    if (inside.empty())
+                        continue;
+                    // Where the part inside the image goes in the output tile
+                    double sx = double(w) / b.width, sy = double(h) / b.height;
+                    int dx0 = cvRound((inside.x - b.x) * sx), dy0 = cvRound((inside.y - b.y) * sy);
+                    int dx1 = cvRound((inside.x + inside.width - b.x) * sx);
+                    int dy1 = cvRound((inside.y + inside.height - b.y) * sy);
+                    if (dx1 <= dx0 || dy1 <= dy0)
+                        continue;
+                    cv::Mat tile = batchMat(cv::Rect(0, i * h, w, h));
+                    cv::Mat dst = tile(cv::Rect(dx0, dy0, dx1 - dx0, dy1 - dy0));
+                    cv::resize(srcMat(inside), dst, dst.size(), 0, 0, options.interpolation());
+                }
+            });
+            return batch;
+        }
+
+        void printStats() const {
+            using namespace std;
+            if (numFrames > 0)
+                cout << "MultiCropCalculator : " << numFrames << " frames, " << double(numCrops) / numFrames
+                     << " crops/frame, " << 1000 * totalSec / numFrames << " ms/frame" << endl;
+        }
+
+        MultiCropCalculatorOptions options;
+        double totalSec = 0;
+        int64 numFrames = 0, numCrops = 0;
+    };
+    REGISTER_CALCULATOR(MultiCropCalculator);
+}
+//==============================================================================